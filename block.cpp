@@ -44,8 +44,17 @@ void Block::setColor(Color c) {
 * Effects: Draws the block to the screen at the specified location
 */
 void Block::draw(int pixelX, int pixelY, int width, int height) const {
+  draw(color, pixelX, pixelY, width, height);
+}
+/**
+* Requires: a valid color, the pixel x and y coordinates to draw the left
+* corner at, and the width and height of the block
+* Modifies: nothing
+* Effects: Draws a block of the color to the screen at the specified location
+*/
+void Block::draw(Color c, int pixelX, int pixelY, int width, int height) {
   // Set the color of the block
-  glColor3f(color.r, color.g, color.b);
+  glColor3f(c.r, c.g, c.b);
 
   // Draw the block
   glBegin(GL_QUADS);
@@ -56,6 +56,14 @@ public:
   */
   void draw(int pixelX, int pixelY, int width, int height) const;
 
+  /**
+  * Requires: a valid color, the pixel x and y coordinates to draw the left
+  * corner at, and the width and height of the block
+  * Modifies: nothing
+  * Effects: Draws a block of the color to the screen at the specified location
+  */
+  static void draw(Color c, int pixelX, int pixelY, int width, int height);
+
   /**
   * Requires: nothing
   * Modifies: nothing
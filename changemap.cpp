@@ -0,0 +1,540 @@
+#include "changemap.hpp"
+#include <algorithm>
+#include <atomic>
+
+// Number of slots a table starts with once something is added
+static const size_t MIN_TABLE_SIZE = 16;
+
+/**
+* Requires: a key and a table size that is a power of two
+* Modifies: nothing
+* Effects: Returns the slot the key would ideally be stored in
+*/
+static size_t idealSlot(uint64_t key, size_t size) {
+  uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+  return (hash ^ (hash >> 32)) & (size - 1);
+}
+
+/**
+* Requires: a table with at least one unused slot
+* Modifies: nothing
+* Effects: Returns the slot holding the key, or the unused slot where it
+* would be added
+*/
+template <typename Slot>
+static size_t findSlot(const vector<Slot> &slots, uint64_t key) {
+  size_t slot = idealSlot(key, slots.size());
+  while (slots[slot].used && slots[slot].key != key) {
+    slot = (slot + 1) & (slots.size() - 1);
+  }
+  return slot;
+}
+
+/**
+* Requires: a table and a larger size that is a power of two
+* Modifies: slots
+* Effects: Moves every used slot into a table of the size
+*/
+template <typename Slot>
+static void growTable(vector<Slot> &slots, size_t size) {
+  vector<Slot> oldSlots(size);
+  oldSlots.swap(slots);
+  for (Slot &oldSlot : oldSlots) {
+    if (oldSlot.used) {
+      slots[findSlot(slots, oldSlot.key)] = move(oldSlot);
+    }
+  }
+}
+
+/**
+* Requires: a table and the number of used slots in it
+* Modifies: slots
+* Effects: Grows the table if adding another slot would make it too full
+*/
+template <typename Slot>
+static void reserveSlot(vector<Slot> &slots, int numUsed) {
+  // Keep the table at most three quarters full, so probes stay short
+  if ((numUsed + 1) * 4 <= slots.size() * 3) {
+    return;
+  }
+
+  // Double the size of the table
+  growTable(slots, max(MIN_TABLE_SIZE, slots.size() * 2));
+}
+
+/**
+* Requires: a used slot in the table
+* Modifies: slots
+* Effects: Empties the slot, shifting back the slots after it so every key can
+* still be found without tombstones
+*/
+template <typename Slot>
+static void eraseSlot(vector<Slot> &slots, size_t slot) {
+  size_t mask = slots.size() - 1;
+  slots[slot].used = false;
+
+  // Look at the run of slots after the emptied one
+  size_t next = slot;
+  while (true) {
+    next = (next + 1) & mask;
+    if (!slots[next].used) {
+      break;
+    }
+
+    // Move the slot back if the emptied slot is between its ideal slot and it
+    size_t ideal = idealSlot(slots[next].key, slots.size());
+    bool between = slot <= next ? (ideal <= slot || ideal > next) : (ideal <= slot && ideal > next);
+    if (between) {
+      slots[slot] = move(slots[next]);
+      slots[next].used = false;
+      slot = next;
+    }
+  }
+}
+
+/**
+* Requires: a list of chunks sorted by index
+* Modifies: nothing
+* Effects: Returns the first chunk in the list whose index is at least the
+* index
+*/
+template <typename ChunkList>
+static auto findChunkSlot(ChunkList &chunks, int index) -> decltype(chunks.begin()) {
+  return lower_bound(chunks.begin(), chunks.end(), index, [](const typename ChunkList::value_type &chunk, int i) { return chunk.first < i; });
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns a token that no map has had yet
+*/
+static uint64_t newOwner() {
+  static atomic<uint64_t> lastOwner(0);
+  return ++lastOwner;
+}
+
+/**
+* Requires: nothing
+* Modifies: the chunks
+* Effects: Creates an empty map of changes
+*/
+ChangeMap::ChangeMap() {
+  numChanges = 0;
+  owner = newOwner();
+}
+
+/**
+* Requires: another map
+* Modifies: the other map's ownership of its chunks
+* Effects: Copies the map in O(1), sharing its chunks until either map
+* changes them
+*/
+ChangeMap::ChangeMap(const ChangeMap &other) {
+  directory = other.directory;
+  numChanges = other.numChanges;
+  owner = newOwner();
+
+  // Neither map can change the shared chunks in place anymore
+  other.owner = newOwner();
+}
+ChangeMap &ChangeMap::operator=(const ChangeMap &other) {
+  if (this != &other) {
+    directory = other.directory;
+    numChanges = other.numChanges;
+    owner = newOwner();
+    other.owner = newOwner();
+  }
+  return *this;
+}
+
+/**
+* Requires: another map
+* Modifies: other
+* Effects: Moves the changes of the other map, leaving it empty
+*/
+ChangeMap::ChangeMap(ChangeMap &&other) {
+  directory = move(other.directory);
+  numChanges = other.numChanges;
+  owner = other.owner;
+  other.directory.reset();
+  other.numChanges = 0;
+  other.owner = newOwner();
+}
+ChangeMap &ChangeMap::operator=(ChangeMap &&other) {
+  if (this != &other) {
+    directory = move(other.directory);
+    numChanges = other.numChanges;
+    owner = other.owner;
+    other.directory.reset();
+    other.numChanges = 0;
+    other.owner = newOwner();
+  }
+  return *this;
+}
+
+/**
+* Requires: a non-negative column and row
+* Modifies: nothing
+* Effects: Packs the column and row into one key, which sorts by column and
+* then row
+*/
+uint64_t ChangeMap::packKey(int column, int row) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) | static_cast<uint32_t>(row);
+}
+
+/**
+* Requires: a packed key
+* Modifies: nothing
+* Effects: Returns the column or row of the key
+*/
+int ChangeMap::unpackColumn(uint64_t key) {
+  return static_cast<int>(key >> 32);
+}
+int ChangeMap::unpackRow(uint64_t key) {
+  return static_cast<int>(key & 0xFFFFFFFF);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of changes, or if there are none
+*/
+int ChangeMap::size() const {
+  return numChanges;
+}
+bool ChangeMap::empty() const {
+  return numChanges == 0;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if the column has any changes
+*/
+bool ChangeMap::hasColumn(int column) const {
+  return getColumnBits(column) != nullptr;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the presence bits of the column's changes (bit (row % 64)
+* of word (row / 64) is set if the row has a change), or nullptr if the
+* column doesn't have any changes
+*/
+const vector<uint64_t> *ChangeMap::getColumnBits(int column) const {
+  const Chunk *chunk = findChunk(column);
+  if (!chunk) {
+    return nullptr;
+  }
+
+  const ColumnChanges &slot = chunk->columns[findSlot(chunk->columns, static_cast<uint32_t>(column))];
+  return slot.used ? &slot.rows : nullptr;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if there is a change at the position
+*/
+bool ChangeMap::hasChange(int column, int row) const {
+  // Test the presence bit, so rows without a change never touch the table
+  const vector<uint64_t> *rows = getColumnBits(column);
+  return rows && row >= 0 && row / 64 < rows->size() && ((*rows)[row / 64] >> (row % 64)) & 1;
+}
+
+/**
+* Requires: a position with a change
+* Modifies: nothing
+* Effects: Returns the changed tile at the position
+*/
+Tile ChangeMap::getChange(int column, int row) const {
+  const Chunk *chunk = findChunk(column);
+  return chunk->changes[findSlot(chunk->changes, packKey(column, row))].tile;
+}
+
+/**
+* Requires: a non-negative column and row
+* Modifies: the chunks
+* Effects: Adds or replaces the change at the position
+*/
+void ChangeMap::setChange(int column, int row, Tile t) {
+  // Replace the change if it is already there
+  Chunk &chunk = editChunk(column);
+  uint64_t key = packKey(column, row);
+  if (chunk.numChanges > 0) {
+    size_t slot = findSlot(chunk.changes, key);
+    if (chunk.changes[slot].used) {
+      chunk.changes[slot].tile = t;
+      return;
+    }
+  }
+
+  // Add the change
+  reserveSlot(chunk.changes, chunk.numChanges);
+  chunk.changes[findSlot(chunk.changes, key)] = {key, t, true};
+  chunk.numChanges++;
+  numChanges++;
+
+  // Add the column if it is new
+  reserveSlot(chunk.columns, chunk.numColumns);
+  ColumnChanges &columnSlot = chunk.columns[findSlot(chunk.columns, static_cast<uint32_t>(column))];
+  if (!columnSlot.used) {
+    columnSlot = {static_cast<uint32_t>(column), true, 0, {}};
+    chunk.numColumns++;
+  }
+
+  // Set the presence bit for the row
+  if (columnSlot.rows.size() <= row / 64) {
+    columnSlot.rows.resize(row / 64 + 1, 0);
+  }
+  columnSlot.rows[row / 64] |= 1ULL << (row % 64);
+  columnSlot.count++;
+}
+
+/**
+* Requires: nothing
+* Modifies: the chunks
+* Effects: Removes the change at the position, returns if there was one
+*/
+bool ChangeMap::removeChange(int column, int row) {
+  // Make sure there is a change to remove
+  if (!hasChange(column, row)) {
+    return false;
+  }
+
+  // Remove the change
+  Chunk &chunk = editChunk(column);
+  eraseSlot(chunk.changes, findSlot(chunk.changes, packKey(column, row)));
+  chunk.numChanges--;
+  numChanges--;
+
+  // Clear the presence bit, and remove the column if it was the last change
+  size_t columnSlot = findSlot(chunk.columns, static_cast<uint32_t>(column));
+  chunk.columns[columnSlot].rows[row / 64] &= ~(1ULL << (row % 64));
+  if (--chunk.columns[columnSlot].count == 0) {
+    eraseSlot(chunk.columns, columnSlot);
+    chunk.numColumns--;
+  }
+
+  // Remove the chunk if it was its last change, so only chunks with changes
+  // are kept
+  if (chunk.numChanges == 0) {
+    directory->chunks.erase(findChunkSlot(directory->chunks, column / CHANGE_CHUNK_WIDTH));
+  }
+
+  return true;
+}
+
+/**
+* Requires: nothing
+* Modifies: the chunks
+* Effects: Removes every change
+*/
+void ChangeMap::clear() {
+  directory.reset();
+  numChanges = 0;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the keys of every change, sorted by column and then row
+*/
+vector<uint64_t> ChangeMap::getSortedKeys() const {
+  vector<uint64_t> keys;
+  keys.reserve(numChanges);
+  for (const Change &change : *this) {
+    keys.push_back(change.key);
+  }
+
+  // The chunks are already in order, so only sort the keys within each one
+  vector<uint64_t>::iterator first = keys.begin();
+  while (first != keys.end()) {
+    int chunk = unpackColumn(*first) / CHANGE_CHUNK_WIDTH;
+    vector<uint64_t>::iterator last = find_if(first, keys.end(), [chunk](uint64_t key) { return unpackColumn(key) / CHANGE_CHUNK_WIDTH != chunk; });
+    sort(first, last);
+    first = last;
+  }
+  return keys;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the keys of the positions whose changes differ from the
+* other map's (including changes only one of them has), sorted by column and
+* then row, skipping the chunks both maps share
+*/
+vector<uint64_t> ChangeMap::getDifferentKeys(const ChangeMap &other) const {
+  vector<uint64_t> keys;
+  if (directory == other.directory) {
+    return keys;
+  }
+
+  // Walk both lists of chunks in order
+  const ChunkList &chunks = getChunks();
+  const ChunkList &otherChunks = other.getChunks();
+  ChunkIterator chunk = chunks.begin();
+  ChunkIterator otherChunk = otherChunks.begin();
+  while (chunk != chunks.end() || otherChunk != otherChunks.end()) {
+    // Find the next chunk either map has, and skip it if it is shared
+    int index = otherChunk == otherChunks.end() || (chunk != chunks.end() && chunk->first < otherChunk->first) ? chunk->first : otherChunk->first;
+    const Chunk *ours = chunk != chunks.end() && chunk->first == index ? (chunk++)->second.get() : nullptr;
+    const Chunk *theirs = otherChunk != otherChunks.end() && otherChunk->first == index ? (otherChunk++)->second.get() : nullptr;
+    if (ours == theirs) {
+      continue;
+    }
+
+    // Add the changes of each chunk that the other doesn't have the same
+    size_t firstKey = keys.size();
+    if (ours) {
+      for (const Change &change : ours->changes) {
+        if (change.used && (!other.hasChange(change.getColumn(), change.getRow()) || other.getChange(change.getColumn(), change.getRow()) != change.tile)) {
+          keys.push_back(change.key);
+        }
+      }
+    }
+    if (theirs) {
+      for (const Change &change : theirs->changes) {
+        if (change.used && !hasChange(change.getColumn(), change.getRow())) {
+          keys.push_back(change.key);
+        }
+      }
+    }
+    sort(keys.begin() + firstKey, keys.end());
+  }
+
+  return keys;
+}
+
+/**
+* Requires: first and last columns that are multiples of CHANGE_CHUNK_WIDTH
+* Modifies: the chunks, and the other map's ownership of its chunks
+* Effects: Replaces the changes from firstColumn up to (but not including)
+* lastColumn with the other map's, sharing its chunks instead of copying them
+*/
+void ChangeMap::shareColumns(const ChangeMap &other, int firstColumn, int lastColumn) {
+  int firstChunk = firstColumn / CHANGE_CHUNK_WIDTH;
+  int lastChunk = lastColumn / CHANGE_CHUNK_WIDTH;
+  if (lastChunk <= firstChunk || directory == other.directory) {
+    return;
+  }
+
+  // Remove our chunks in the range
+  ChunkList &chunks = editChunks();
+  ChunkList::iterator first = findChunkSlot(chunks, firstChunk);
+  ChunkList::iterator last = findChunkSlot(chunks, lastChunk);
+  for (ChunkList::iterator chunk = first; chunk != last; chunk++) {
+    numChanges -= chunk->second->numChanges;
+  }
+  first = chunks.erase(first, last);
+
+  // Add the other map's, which neither map can change in place anymore
+  const ChunkList &otherChunks = other.getChunks();
+  ChunkIterator otherFirst = findChunkSlot(otherChunks, firstChunk);
+  ChunkIterator otherLast = findChunkSlot(otherChunks, lastChunk);
+  for (ChunkIterator otherChunk = otherFirst; otherChunk != otherLast; otherChunk++) {
+    numChanges += otherChunk->second->numChanges;
+  }
+  chunks.insert(first, otherFirst, otherLast);
+  other.owner = newOwner();
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns iterators over the changes
+*/
+ChangeMap::const_iterator ChangeMap::begin() const {
+  return const_iterator(getChunks().begin(), getChunks().end());
+}
+ChangeMap::const_iterator ChangeMap::end() const {
+  return const_iterator(getChunks().end(), getChunks().end());
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if both maps hold the same changes
+*/
+bool ChangeMap::operator==(const ChangeMap &other) const {
+  if (numChanges != other.numChanges) {
+    return false;
+  }
+  if (directory == other.directory) {
+    return true;
+  }
+  for (const Change &change : *this) {
+    if (!other.hasChange(change.getColumn(), change.getRow()) || other.getChange(change.getColumn(), change.getRow()) != change.tile) {
+      return false;
+    }
+  }
+  return true;
+}
+bool ChangeMap::operator!=(const ChangeMap &other) const {
+  return !(*this == other);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the chunks of the map
+*/
+const ChangeMap::ChunkList &ChangeMap::getChunks() const {
+  static const ChunkList noChunks;
+  return directory ? directory->chunks : noChunks;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the chunk holding the column, or nullptr if it doesn't
+* have any changes
+*/
+const ChangeMap::Chunk *ChangeMap::findChunk(int column) const {
+  if (!directory || column < 0) {
+    return nullptr;
+  }
+  ChunkIterator chunk = findChunkSlot(directory->chunks, column / CHANGE_CHUNK_WIDTH);
+  return chunk != directory->chunks.end() && chunk->first == column / CHANGE_CHUNK_WIDTH ? chunk->second.get() : nullptr;
+}
+
+/**
+* Requires: a non-negative column
+* Modifies: directory
+* Effects: Returns the chunk holding the column to change it, copying it (and
+* the directory) first if it is shared with another map
+*/
+ChangeMap::Chunk &ChangeMap::editChunk(int column) {
+  // Add the chunk if it isn't there yet
+  ChunkList &chunks = editChunks();
+  int index = column / CHANGE_CHUNK_WIDTH;
+  ChunkList::iterator slot = findChunkSlot(chunks, index);
+  if (slot == chunks.end() || slot->first != index) {
+    slot = chunks.insert(slot, {index, nullptr});
+  }
+
+  // Copy it if another map shares it
+  shared_ptr<Chunk> &chunk = slot->second;
+  if (!chunk) {
+    chunk = make_shared<Chunk>();
+    chunk->numChanges = 0;
+    chunk->numColumns = 0;
+    chunk->owner = owner;
+  } else if (chunk->owner != owner) {
+    chunk = make_shared<Chunk>(*chunk);
+    chunk->owner = owner;
+  }
+  return *chunk;
+}
+ChangeMap::ChunkList &ChangeMap::editChunks() {
+  if (!directory) {
+    directory = make_shared<Directory>();
+    directory->owner = owner;
+  } else if (directory->owner != owner) {
+    directory = make_shared<Directory>(*directory);
+    directory->owner = owner;
+  }
+  return directory->chunks;
+}
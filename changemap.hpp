@@ -0,0 +1,292 @@
+#ifndef changemap_hpp
+#define changemap_hpp
+
+#include "tile.hpp"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Number of columns of changes stored in each chunk
+const int CHANGE_CHUNK_WIDTH = 64;
+
+// Stores the changes in chunks of columns that are shared between copies of
+// the map until one of them changes them, so a copy only costs O(1) and an
+// edit after it only copies the chunk it changes
+//  Note: a copy (or a map sharing chunks with another) gives up the right to
+//  change its chunks in place, so maps that share chunks can be used from
+//  different threads
+class ChangeMap {
+public:
+  // One slot of a chunk's hash table
+  struct Change {
+    uint64_t key; // Packed column and row
+    Tile tile;    // Changed tile at the position
+    bool used;    // If the slot holds a change
+
+    // Returns the column or row of the change
+    int getColumn() const {
+      return unpackColumn(key);
+    }
+    int getRow() const {
+      return unpackRow(key);
+    }
+  };
+
+private:
+  // Presence bits for one column of changes
+  struct ColumnChanges {
+    uint64_t key;          // Column
+    bool used;             // If the slot holds a column
+    int count;             // Number of changes in the column
+    vector<uint64_t> rows; // Bit (row % 64) of rows[row / 64] is set for each change
+  };
+
+  // Open addressing tables of changes and columns for CHANGE_CHUNK_WIDTH
+  // columns, whose sizes are always powers of two
+  struct Chunk {
+    vector<Change> changes;
+    vector<ColumnChanges> columns;
+    int numChanges; // Number of used slots in each table
+    int numColumns;
+    uint64_t owner; // Map that can change the chunk in place
+  };
+
+  // Chunks that have changes, sorted by their column / CHANGE_CHUNK_WIDTH
+  typedef vector<pair<int, shared_ptr<Chunk>>> ChunkList;
+  typedef ChunkList::const_iterator ChunkIterator;
+  struct Directory {
+    ChunkList chunks;
+    uint64_t owner; // Map that can change the directory in place
+  };
+
+public:
+  // Iterates over the changes in the chunks (in order of chunk, but in no
+  // particular order within a chunk)
+  class const_iterator {
+  public:
+    const_iterator(ChunkIterator c, ChunkIterator l) : chunk(c), lastChunk(l) {
+      startChunk();
+      skipUnused();
+    }
+    const Change &operator*() const {
+      return *slot;
+    }
+    const Change *operator->() const {
+      return slot;
+    }
+    const_iterator &operator++() {
+      slot++;
+      skipUnused();
+      return *this;
+    }
+    bool operator==(const const_iterator &other) const {
+      return chunk == other.chunk && slot == other.slot;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return !(*this == other);
+    }
+
+  private:
+    ChunkIterator chunk;
+    ChunkIterator lastChunk;
+    const Change *slot;
+    const Change *end;
+    void startChunk() {
+      slot = end = nullptr;
+      if (chunk != lastChunk) {
+        slot = chunk->second->changes.data();
+        end = slot + chunk->second->changes.size();
+      }
+    }
+    void skipUnused() {
+      while (true) {
+        while (slot != end && !slot->used) {
+          slot++;
+        }
+        if (slot != end || chunk == lastChunk) {
+          return;
+        }
+        ++chunk;
+        startChunk();
+      }
+    }
+  };
+
+  /**
+  * Requires: nothing
+  * Modifies: the tables
+  * Effects: Creates an empty map of changes
+  */
+  ChangeMap();
+
+  /**
+  * Requires: another map
+  * Modifies: the other map's ownership of its chunks
+  * Effects: Copies the map in O(1), sharing its chunks until either map
+  * changes them
+  */
+  ChangeMap(const ChangeMap &other);
+  ChangeMap &operator=(const ChangeMap &other);
+
+  /**
+  * Requires: another map
+  * Modifies: other
+  * Effects: Moves the changes of the other map, leaving it empty
+  */
+  ChangeMap(ChangeMap &&other);
+  ChangeMap &operator=(ChangeMap &&other);
+
+  /**
+  * Requires: a non-negative column and row
+  * Modifies: nothing
+  * Effects: Packs the column and row into one key, which sorts by column and
+  * then row
+  */
+  static uint64_t packKey(int column, int row);
+
+  /**
+  * Requires: a packed key
+  * Modifies: nothing
+  * Effects: Returns the column or row of the key
+  */
+  static int unpackColumn(uint64_t key);
+  static int unpackRow(uint64_t key);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of changes, or if there are none
+  */
+  int size() const;
+  bool empty() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if the column has any changes
+  */
+  bool hasColumn(int column) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the presence bits of the column's changes (bit (row % 64)
+  * of word (row / 64) is set if the row has a change), or nullptr if the
+  * column doesn't have any changes
+  */
+  const vector<uint64_t> *getColumnBits(int column) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if there is a change at the position
+  */
+  bool hasChange(int column, int row) const;
+
+  /**
+  * Requires: a position with a change
+  * Modifies: nothing
+  * Effects: Returns the changed tile at the position
+  */
+  Tile getChange(int column, int row) const;
+
+  /**
+  * Requires: a non-negative column and row
+  * Modifies: the tables
+  * Effects: Adds or replaces the change at the position
+  */
+  void setChange(int column, int row, Tile t);
+
+  /**
+  * Requires: nothing
+  * Modifies: the tables
+  * Effects: Removes the change at the position, returns if there was one
+  */
+  bool removeChange(int column, int row);
+
+  /**
+  * Requires: nothing
+  * Modifies: the tables
+  * Effects: Removes every change
+  */
+  void clear();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the keys of every change, sorted by column and then row
+  */
+  vector<uint64_t> getSortedKeys() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the keys of the positions whose changes differ from the
+  * other map's (including changes only one of them has), sorted by column and
+  * then row, skipping the chunks both maps share
+  */
+  vector<uint64_t> getDifferentKeys(const ChangeMap &other) const;
+
+  /**
+  * Requires: first and last columns that are multiples of CHANGE_CHUNK_WIDTH
+  * Modifies: the chunks, and the other map's ownership of its chunks
+  * Effects: Replaces the changes from firstColumn up to (but not including)
+  * lastColumn with the other map's, sharing its chunks instead of copying them
+  */
+  void shareColumns(const ChangeMap &other, int firstColumn, int lastColumn);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns iterators over the changes
+  */
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if both maps hold the same changes
+  */
+  bool operator==(const ChangeMap &other) const;
+  bool operator!=(const ChangeMap &other) const;
+
+private:
+  // Store the chunks (nullptr until a change is added), and the number of
+  // changes in them
+  shared_ptr<Directory> directory;
+  int numChanges;
+
+  // Store the token of the map, which chunks made by it keep so they are only
+  // changed in place by it
+  mutable uint64_t owner;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the chunks of the map
+  */
+  const ChunkList &getChunks() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the chunk holding the column, or nullptr if it doesn't
+  * have any changes
+  */
+  const Chunk *findChunk(int column) const;
+
+  /**
+  * Requires: a non-negative column
+  * Modifies: directory
+  * Effects: Returns the chunk holding the column to change it, copying it (and
+  * the directory) first if it is shared with another map
+  */
+  Chunk &editChunk(int column);
+  ChunkList &editChunks();
+};
+
+#endif
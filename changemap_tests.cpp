@@ -0,0 +1,181 @@
+#include "changemap_tests.hpp"
+#include <map>
+
+bool changeMapTests_run() {
+  cout << "Running Change Map Tests:" << endl;
+  cout << "-------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(changeMapTests_setChange());
+  t.check(changeMapTests_removeChange());
+  t.check(changeMapTests_copy());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test setChange(), hasChange(), getChange(), and getColumnBits()
+bool changeMapTests_setChange() {
+  // Start new testing object
+  Testing t("setChange(), hasChange(), getChange(), and getColumnBits()");
+
+  // Create an empty map
+  ChangeMap m;
+  t.check(m.empty() && m.size() == 0 && !m.hasChange(0, 0) && !m.hasColumn(0) && m.begin() == m.end(), "Empty map isn't empty");
+
+  // Add a few changes, including one far down the column
+  m.setChange(3, 1, WALL_TILE);
+  m.setChange(3, 130, GRASS_TILE);
+  m.setChange(100000, 0, WALL_TILE);
+  t.check(m.size() == 3 && m.hasChange(3, 1) && m.hasChange(3, 130) && m.hasChange(100000, 0), "Changes weren't added");
+  t.check(!m.hasChange(3, 0) && !m.hasChange(3, 129) && !m.hasChange(4, 1) && !m.hasChange(3, -1), "Unchanged positions have changes");
+  t.check(m.getChange(3, 1) == WALL_TILE && m.getChange(3, 130) == GRASS_TILE, "Changed tiles weren't stored");
+
+  // The presence bits should have one bit per changed row
+  const vector<uint64_t> *rows = m.getColumnBits(3);
+  t.check(rows && rows->size() == 3 && (*rows)[0] == 2 && (*rows)[1] == 0 && (*rows)[2] == 4, "Presence bits don't match the changed rows");
+  t.check(!m.getColumnBits(5), "Unchanged column has presence bits");
+
+  // Replacing a change shouldn't add another one
+  m.setChange(3, 1, GRASS_TILE);
+  t.check(m.size() == 3 && m.getChange(3, 1) == GRASS_TILE, "Change wasn't replaced");
+
+  // Compare maps with the same and different changes
+  ChangeMap m2;
+  m2.setChange(100000, 0, WALL_TILE);
+  m2.setChange(3, 130, GRASS_TILE);
+  m2.setChange(3, 1, GRASS_TILE);
+  t.check(m == m2, "Maps with the same changes aren't equal");
+  m2.setChange(3, 1, WALL_TILE);
+  t.check(m != m2, "Maps with different changes are equal");
+
+  // Clearing should remove every change
+  m.clear();
+  t.check(m.empty() && !m.hasChange(3, 1) && !m.hasColumn(3), "clear() didn't remove the changes");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test removeChange(), getSortedKeys(), and iterating, against a map
+bool changeMapTests_removeChange() {
+  // Start new testing object
+  Testing t("removeChange(), getSortedKeys(), and iterating");
+
+  // Add and remove many changes in both a ChangeMap and a std::map
+  ChangeMap m;
+  map<uint64_t, Tile> expected;
+  uint32_t state = 12345;
+  for (int i = 0; i < 20000; i++) {
+    state = state * 1664525 + 1013904223;
+    int column = (state >> 8) % 300;
+    int row = (state >> 20) % 200;
+    if ((state & 3) == 0) {
+      bool removed = m.removeChange(column, row);
+      t.check(removed == (expected.erase(ChangeMap::packKey(column, row)) == 1), "removeChange() didn't match the map");
+    } else {
+      Tile tile = (state & 4) ? WALL_TILE : GRASS_TILE;
+      m.setChange(column, row, tile);
+      expected[ChangeMap::packKey(column, row)] = tile;
+    }
+  }
+  t.check(m.size() == expected.size(), "Number of changes doesn't match the map");
+
+  // Every change should be found, and the sorted keys should match the map
+  bool found = true;
+  for (const pair<const uint64_t, Tile> &change : expected) {
+    int column = ChangeMap::unpackColumn(change.first);
+    int row = ChangeMap::unpackRow(change.first);
+    found = found && m.hasChange(column, row) && m.getChange(column, row) == change.second;
+  }
+  t.check(found, "Changes weren't found after removing");
+  vector<uint64_t> keys = m.getSortedKeys();
+  t.check(keys.size() == expected.size() && equal(keys.begin(), keys.end(), expected.begin(), [](uint64_t key, const pair<const uint64_t, Tile> &change) { return key == change.first; }), "Sorted keys don't match the map");
+
+  // Iterating should visit every change once
+  int numVisited = 0;
+  for (const ChangeMap::Change &change : m) {
+    numVisited += expected.count(change.key);
+  }
+  t.check(numVisited == expected.size(), "Iterating didn't visit every change");
+
+  // Removing every change should also remove the columns
+  for (uint64_t key : keys) {
+    m.removeChange(ChangeMap::unpackColumn(key), ChangeMap::unpackRow(key));
+  }
+  bool hasColumn = false;
+  for (int column = 0; column < 300; column++) {
+    hasColumn = hasColumn || m.hasColumn(column);
+  }
+  t.check(m.empty() && !hasColumn, "Removing every change didn't remove the columns");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test copying, getDifferentKeys(), and shareColumns()
+bool changeMapTests_copy() {
+  // Start new testing object
+  Testing t("copying, getDifferentKeys(), and shareColumns()");
+
+  // Fill a map with changes in a few chunks
+  ChangeMap m;
+  for (int column = 0; column < 4 * CHANGE_CHUNK_WIDTH; column += 3) {
+    m.setChange(column, column % 7, WALL_TILE);
+  }
+
+  // A copy should have the same changes, and not differ anywhere
+  ChangeMap copy = m;
+  t.check(copy == m && copy.size() == m.size() && m.getDifferentKeys(copy).empty(), "Copy doesn't have the same changes");
+
+  // Changing either map shouldn't change the other
+  copy.setChange(CHANGE_CHUNK_WIDTH + 1, 2, GRASS_TILE);
+  m.removeChange(0, 0);
+  t.check(!m.hasChange(CHANGE_CHUNK_WIDTH + 1, 2) && copy.hasChange(0, 0) && copy.size() == m.size() + 2, "Changing a copy changed the other map");
+  vector<uint64_t> keys = m.getDifferentKeys(copy);
+  t.check(keys.size() == 2 && keys[0] == ChangeMap::packKey(0, 0) && keys[1] == ChangeMap::packKey(CHANGE_CHUNK_WIDTH + 1, 2), "Different keys don't match the edits");
+
+  // Replacing a change with a different tile should also differ
+  ChangeMap replaced = copy;
+  replaced.setChange(3, 3, GRASS_TILE);
+  keys = replaced.getDifferentKeys(copy);
+  t.check(keys.size() == 1 && keys[0] == ChangeMap::packKey(3, 3) && copy.getChange(3, 3) == WALL_TILE, "Replaced change doesn't differ");
+
+  // Assigning and moving should keep the changes
+  ChangeMap assigned;
+  assigned.setChange(9, 9, WALL_TILE);
+  assigned = copy;
+  ChangeMap moved = move(replaced);
+  t.check(assigned == copy && moved.getChange(3, 3) == GRASS_TILE && replaced.empty(), "Assigning or moving lost the changes");
+
+  // Sharing columns should replace just those chunks
+  ChangeMap shared;
+  shared.setChange(5, 5, GRASS_TILE);
+  shared.setChange(3 * CHANGE_CHUNK_WIDTH, 1, GRASS_TILE);
+  shared.shareColumns(copy, 0, 2 * CHANGE_CHUNK_WIDTH);
+  bool isShared = !shared.hasChange(5, 5) && shared.hasChange(3 * CHANGE_CHUNK_WIDTH, 1);
+  int numShared = 0;
+  for (const ChangeMap::Change &change : copy) {
+    if (change.getColumn() < 2 * CHANGE_CHUNK_WIDTH) {
+      isShared = isShared && shared.hasChange(change.getColumn(), change.getRow()) && shared.getChange(change.getColumn(), change.getRow()) == change.tile;
+      numShared++;
+    }
+  }
+  t.check(isShared && shared.size() == numShared + 1, "Shared columns don't match the other map");
+
+  // Changing the shared chunks afterwards shouldn't change the other map
+  copy.setChange(1, 1, GRASS_TILE);
+  shared.setChange(2, 2, GRASS_TILE);
+  t.check(!shared.hasChange(1, 1) && !copy.hasChange(2, 2), "Changing a shared chunk changed the other map");
+
+  return t.getResult(); // Return pass or fail result
+}
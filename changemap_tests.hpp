@@ -0,0 +1,35 @@
+#ifndef changemap_tests_hpp
+#define changemap_tests_hpp
+
+#include "changemap.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool changeMapTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests setChange(), hasChange(), getChange(), and getColumnBits()
+*/
+bool changeMapTests_setChange();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests removeChange(), getSortedKeys(), and iterating, against a map
+*/
+bool changeMapTests_removeChange();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests copying, getDifferentKeys(), and shareColumns()
+*/
+bool changeMapTests_copy();
+
+#endif
@@ -0,0 +1,134 @@
+#include "columnprefetcher.hpp"
+
+/**
+* Requires: a random access generator, a positive number of rows and columns
+* ahead, and the first column to generate
+* Modifies: everything
+* Effects: Starts a thread that generates the columns from the first column
+* up to the number of columns ahead of it
+*/
+ColumnPrefetcher::ColumnPrefetcher(const Generator &g, int nRows, int nAhead, int firstColumn) : generator(g), slots(nAhead), head(0), tail(0), edge(firstColumn), stopping(false) {
+  numRows = nRows;
+  numAhead = nAhead;
+  nextColumn = firstColumn;
+
+  // Size every slot up front, so the producer never allocates
+  for (Slot &slot : slots) {
+    slot.tiles.resize(numRows);
+  }
+
+  producer = thread(&ColumnPrefetcher::run, this);
+}
+
+/**
+* Requires: nothing
+* Modifies: everything
+* Effects: Stops and joins the thread
+*/
+ColumnPrefetcher::~ColumnPrefetcher() {
+  stopping = true;
+  notify();
+  producer.join();
+}
+
+/**
+* Requires: a non-negative column
+* Modifies: edge
+* Effects: Keeps the columns from the column up to the number of columns ahead
+* of it generated
+*/
+void ColumnPrefetcher::setEdge(int column) {
+  edge.store(column, memory_order_release);
+  notify();
+}
+
+/**
+* Requires: a non-negative column and room for a column of tiles
+* Modifies: tiles and the generated columns
+* Effects: Copies the generated tiles of the column if they are ready, and
+* drops the generated columns before it, returns if the column was ready
+*/
+bool ColumnPrefetcher::takeColumn(int column, Tile *tiles) {
+  size_t first = head.load(memory_order_relaxed);
+  size_t last = tail.load(memory_order_acquire);
+
+  // Drop the columns before the one we want, since the board has moved past them
+  while (first < last && slots[first % slots.size()].column < column) {
+    first++;
+  }
+
+  // Copy the column if it is next
+  bool isReady = first < last && slots[first % slots.size()].column == column;
+  if (isReady) {
+    const vector<Tile> &slotTiles = slots[first % slots.size()].tiles;
+    copy(slotTiles.begin(), slotTiles.end(), tiles);
+    first++;
+  }
+
+  // Hand the used slots back to the producer
+  head.store(first, memory_order_release);
+  notify();
+
+  return isReady;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if the producer has a column to generate or should stop
+*/
+bool ColumnPrefetcher::hasWork() const {
+  if (stopping) {
+    return true;
+  }
+  int wanted = edge.load(memory_order_acquire);
+  bool hasRoom = tail.load(memory_order_relaxed) - head.load(memory_order_acquire) < slots.size();
+  return hasRoom && max(nextColumn, wanted) < wanted + numAhead;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Wakes the producer
+*/
+void ColumnPrefetcher::notify() {
+  // Take the lock so the producer can't miss the wake up between checking for
+  // work and sleeping
+  {
+    lock_guard<mutex> lock(wakeMutex);
+  }
+  wake.notify_one();
+}
+
+/**
+* Requires: nothing
+* Modifies: slots, tail, and nextColumn
+* Effects: Generates columns ahead of the edge until stopped
+*/
+void ColumnPrefetcher::run() {
+  vector<uint64_t> wallBits;
+  while (!stopping) {
+    // Sleep until there is room for a column the board will want
+    if (!hasWork()) {
+      unique_lock<mutex> lock(wakeMutex);
+      wake.wait(lock, [this] { return hasWork(); });
+      continue;
+    }
+
+    // Skip ahead if the board moved past the columns we would generate
+    nextColumn = max(nextColumn, edge.load(memory_order_acquire));
+
+    // Generate the column into the next free slot
+    size_t last = tail.load(memory_order_relaxed);
+    Slot &slot = slots[last % slots.size()];
+    slot.column = nextColumn;
+    generator.generateColumn(nextColumn, numRows, wallBits);
+    for (int row = 0; row < numRows; row++) {
+      slot.tiles[row] = (wallBits[row / 64] & (1ULL << (row % 64))) ? WALL_TILE : GRASS_TILE;
+    }
+
+    // Publish the column to the board
+    tail.store(last + 1, memory_order_release);
+    nextColumn++;
+  }
+}
@@ -0,0 +1,101 @@
+#ifndef columnprefetcher_hpp
+#define columnprefetcher_hpp
+
+#include "generator.hpp"
+#include "tile.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ColumnPrefetcher {
+public:
+  /**
+  * Requires: a random access generator, a positive number of rows and columns
+  * ahead, and the first column to generate
+  * Modifies: everything
+  * Effects: Starts a thread that generates the columns from the first column
+  * up to the number of columns ahead of it
+  */
+  ColumnPrefetcher(const Generator &g, int nRows, int nAhead, int firstColumn);
+
+  /**
+  * Requires: nothing
+  * Modifies: everything
+  * Effects: Stops and joins the thread
+  */
+  ~ColumnPrefetcher();
+
+  /**
+  * Requires: a non-negative column
+  * Modifies: edge
+  * Effects: Keeps the columns from the column up to the number of columns ahead
+  * of it generated
+  */
+  void setEdge(int column);
+
+  /**
+  * Requires: a non-negative column and room for a column of tiles
+  * Modifies: tiles and the generated columns
+  * Effects: Copies the generated tiles of the column if they are ready, and
+  * drops the generated columns before it, returns if the column was ready
+  */
+  bool takeColumn(int column, Tile *tiles);
+
+private:
+  // One generated column waiting to be taken
+  struct Slot {
+    int column;
+    vector<Tile> tiles;
+  };
+
+  // Store the producer's own copy of the generator, so columns match the
+  // board's generator exactly
+  Generator generator;
+  int numRows;
+  int numAhead;
+
+  // Store the ring of generated columns, which are in increasing order
+  //  Note: the producer only writes slots [tail, head + size) and the consumer
+  //  only reads slots [head, tail), so the two never touch the same slot
+  vector<Slot> slots;
+  atomic<size_t> head;
+  atomic<size_t> tail;
+
+  // Store the first column the board will ask for next
+  atomic<int> edge;
+
+  // Next column the producer will generate (only used by the producer)
+  int nextColumn;
+
+  // The lock is only held to sleep and wake the producer, never while
+  // generating or taking a column
+  atomic<bool> stopping;
+  mutex wakeMutex;
+  condition_variable wake;
+  thread producer;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if the producer has a column to generate or should stop
+  */
+  bool hasWork() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Wakes the producer
+  */
+  void notify();
+
+  /**
+  * Requires: nothing
+  * Modifies: slots, tail, and nextColumn
+  * Effects: Generates columns ahead of the edge until stopped
+  */
+  void run();
+};
+
+#endif
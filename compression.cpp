@@ -0,0 +1,162 @@
+#include "compression.hpp"
+#include <cstring>
+
+// Shortest match worth storing, and the farthest one back
+static const int MIN_MATCH_LENGTH = 4;
+static const size_t MAX_MATCH_DISTANCE = 0xFFFF;
+
+// Number of bits in the hash of 4 bytes that finds earlier matches
+static const int MATCH_HASH_BITS = 14;
+
+// Last bytes that are always literals, so matches never read past the end
+static const size_t LAST_LITERALS = 5;
+
+/**
+* Requires: 4 readable bytes
+* Modifies: nothing
+* Effects: Returns the bytes as a number
+*/
+static uint32_t read32(const uint8_t *bytes) {
+  uint32_t value;
+  memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+/**
+* Requires: a length past 15 (or exactly 15)
+* Modifies: compressed
+* Effects: Appends the rest of the length in bytes of 255
+*/
+static void putLength(vector<uint8_t> &compressed, size_t length) {
+  for (length -= 15; length >= 255; length -= 255) {
+    compressed.push_back(255);
+  }
+  compressed.push_back(static_cast<uint8_t>(length));
+}
+
+/**
+* Requires: the literals and match of a sequence
+* Modifies: compressed
+* Effects: Appends the sequence (without a match if matchLength is 0)
+*/
+static void putSequence(vector<uint8_t> &compressed, const uint8_t *literals, size_t numLiterals, size_t distance, size_t matchLength) {
+  size_t matchCode = matchLength > 0 ? matchLength - MIN_MATCH_LENGTH : 0;
+  compressed.push_back(static_cast<uint8_t>((numLiterals < 15 ? numLiterals : 15) << 4 | (matchCode < 15 ? matchCode : 15)));
+  if (numLiterals >= 15) {
+    putLength(compressed, numLiterals);
+  }
+  compressed.insert(compressed.end(), literals, literals + numLiterals);
+  if (matchLength > 0) {
+    compressed.push_back(static_cast<uint8_t>(distance));
+    compressed.push_back(static_cast<uint8_t>(distance >> 8));
+    if (matchCode >= 15) {
+      putLength(compressed, matchCode);
+    }
+  }
+}
+
+/**
+* Requires: bytes to compress
+* Modifies: compressed
+* Effects: Appends the compressed bytes to compressed
+*/
+void compressBlock(const uint8_t *bytes, size_t size, vector<uint8_t> &compressed) {
+  // Remember the last position of each hash of 4 bytes (plus one, so 0 means
+  // none)
+  vector<uint32_t> lastPositions(1 << MATCH_HASH_BITS, 0);
+
+  size_t literalStart = 0;
+  size_t position = 0;
+  while (size >= LAST_LITERALS + MIN_MATCH_LENGTH && position + MIN_MATCH_LENGTH + LAST_LITERALS <= size) {
+    // Look up the last time these 4 bytes were seen
+    uint32_t value = read32(bytes + position);
+    uint32_t hash = (value * 2654435761U) >> (32 - MATCH_HASH_BITS);
+    size_t candidate = lastPositions[hash];
+    lastPositions[hash] = position + 1;
+    if (candidate == 0 || position - (candidate - 1) > MAX_MATCH_DISTANCE || read32(bytes + candidate - 1) != value) {
+      position++;
+      continue;
+    }
+    candidate--;
+
+    // Extend the match as far as it goes (leaving the last literals)
+    size_t length = MIN_MATCH_LENGTH;
+    while (position + length + LAST_LITERALS < size && bytes[candidate + length] == bytes[position + length]) {
+      length++;
+    }
+
+    putSequence(compressed, bytes + literalStart, position - literalStart, position - candidate, length);
+    position += length;
+    literalStart = position;
+  }
+
+  // End with the rest as literals
+  putSequence(compressed, bytes + literalStart, size - literalStart, 0, 0);
+}
+
+/**
+* Requires: compressed bytes, and room for the number of bytes they hold
+* Modifies: bytes
+* Effects: Decompresses the bytes, returns if they were valid and held exactly
+* size bytes
+*/
+bool decompressBlock(const uint8_t *compressed, size_t compressedSize, uint8_t *bytes, size_t size) {
+  const uint8_t *next = compressed;
+  const uint8_t *end = compressed + compressedSize;
+  size_t position = 0;
+
+  // Reads a length continued in bytes of 255, or returns false
+  auto getLength = [&next, end](size_t &length) {
+    uint8_t byte;
+    do {
+      if (next == end) {
+        return false;
+      }
+      byte = *next++;
+      length += byte;
+    } while (byte == 255);
+    return true;
+  };
+
+  while (next < end) {
+    // Copy the literals
+    uint8_t token = *next++;
+    size_t numLiterals = token >> 4;
+    if (numLiterals == 15 && !getLength(numLiterals)) {
+      return false;
+    }
+    if (numLiterals > static_cast<size_t>(end - next) || numLiterals > size - position) {
+      return false;
+    }
+    if (numLiterals > 0) {
+      memcpy(bytes + position, next, numLiterals);
+    }
+    next += numLiterals;
+    position += numLiterals;
+
+    // The last sequence doesn't have a match
+    if (next == end) {
+      break;
+    }
+
+    // Copy the match a byte at a time, since it can overlap what it writes
+    if (end - next < 2) {
+      return false;
+    }
+    size_t distance = next[0] | (next[1] << 8);
+    next += 2;
+    size_t length = token & 0xF;
+    if (length == 15 && !getLength(length)) {
+      return false;
+    }
+    length += MIN_MATCH_LENGTH;
+    if (distance == 0 || distance > position || length > size - position) {
+      return false;
+    }
+    for (size_t i = 0; i < length; i++, position++) {
+      bytes[position] = bytes[position - distance];
+    }
+  }
+
+  return position == size;
+}
@@ -0,0 +1,35 @@
+#ifndef compression_hpp
+#define compression_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Largest number of bytes a compressed block can grow to per byte it stores,
+// used to reject blocks that claim an impossible size
+const int MAX_COMPRESSION_RATIO = 255;
+
+// A small LZ77 codec in the style of LZ4: each sequence is a token byte (the
+// number of literals in the high 4 bits and the match length minus
+// MIN_MATCH_LENGTH in the low 4, each continued in extra bytes of 255 when it
+// is 15), the literals, and the distance back to the match as 2 bytes (the
+// last sequence is only literals)
+
+/**
+* Requires: bytes to compress
+* Modifies: compressed
+* Effects: Appends the compressed bytes to compressed
+*/
+void compressBlock(const uint8_t *bytes, size_t size, vector<uint8_t> &compressed);
+
+/**
+* Requires: compressed bytes, and room for the number of bytes they hold
+* Modifies: bytes
+* Effects: Decompresses the bytes, returns if they were valid and held exactly
+* size bytes
+*/
+bool decompressBlock(const uint8_t *compressed, size_t compressedSize, uint8_t *bytes, size_t size);
+
+#endif
@@ -0,0 +1,116 @@
+#include "compression_tests.hpp"
+#include <random>
+
+/**
+* Requires: bytes
+* Modifies: nothing
+* Effects: Returns if the bytes come back the same after compressing them
+*/
+static bool roundTrips(const vector<uint8_t> &bytes) {
+  vector<uint8_t> compressed;
+  compressBlock(bytes.data(), bytes.size(), compressed);
+  vector<uint8_t> decompressed(bytes.size());
+  return decompressBlock(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) && decompressed == bytes;
+}
+
+bool compressionTests_run() {
+  cout << "Running Compression Tests:" << endl;
+  cout << "--------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(compressionTests_roundTrip());
+  t.check(compressionTests_damaged());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test compressBlock() and decompressBlock() on different kinds of bytes
+bool compressionTests_roundTrip() {
+  // Start new testing object
+  Testing t("compressBlock() and decompressBlock()");
+
+  // Empty and short blocks are only literals
+  t.check(roundTrips({}) && roundTrips({42}) && roundTrips({1, 2, 3, 4, 5, 6, 7, 8}), "Short block didn't round trip");
+
+  // Long runs of one byte overlap the bytes they copy, and need extra length
+  // bytes
+  vector<uint8_t> run(100000, 7);
+  vector<uint8_t> compressed;
+  compressBlock(run.data(), run.size(), compressed);
+  t.check(roundTrips(run) && compressed.size() < run.size() / 100, "Run of one byte didn't compress");
+
+  // Repeated records (like changes) should shrink, and random bytes shouldn't
+  // grow much
+  mt19937 random(42);
+  vector<uint8_t> records;
+  for (int i = 0; i < 5000; i++) {
+    records.insert(records.end(), {static_cast<uint8_t>(random() % 3), 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+  }
+  vector<uint8_t> noise(70000);
+  for (uint8_t &byte : noise) {
+    byte = random();
+  }
+  compressed.clear();
+  compressBlock(records.data(), records.size(), compressed);
+  t.check(roundTrips(records) && compressed.size() < records.size() / 2, "Repeated records didn't compress");
+  compressed.clear();
+  compressBlock(noise.data(), noise.size(), compressed);
+  t.check(roundTrips(noise) && compressed.size() < noise.size() + noise.size() / 100 + 16, "Random bytes grew too much");
+
+  // Matches farther back than the distance can reach should be literals
+  vector<uint8_t> far = noise;
+  far.insert(far.end(), noise.begin(), noise.begin() + 1000);
+  t.check(roundTrips(far), "Block with a match out of reach didn't round trip");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test that decompressBlock() rejects damaged blocks
+bool compressionTests_damaged() {
+  // Start new testing object
+  Testing t("decompressBlock() with damaged blocks");
+
+  vector<uint8_t> bytes;
+  for (int i = 0; i < 1000; i++) {
+    bytes.push_back(i % 10 == 0 ? i : 1);
+  }
+  vector<uint8_t> compressed;
+  compressBlock(bytes.data(), bytes.size(), compressed);
+  vector<uint8_t> decompressed(bytes.size());
+
+  // Blocks that are cut off, or hold a different size, should be rejected
+  bool rejected = true;
+  for (size_t size = 0; size < compressed.size(); size++) {
+    rejected = rejected && !decompressBlock(compressed.data(), size, decompressed.data(), decompressed.size());
+  }
+  t.check(rejected, "Cut off block was decompressed");
+  t.check(!decompressBlock(compressed.data(), compressed.size(), decompressed.data(), decompressed.size() - 1), "Block was decompressed into too little room");
+  vector<uint8_t> larger(bytes.size() + 1);
+  t.check(!decompressBlock(compressed.data(), compressed.size(), larger.data(), larger.size()), "Block was decompressed into too much room");
+
+  // Matches from before the start of the block should be rejected
+  vector<uint8_t> before = {0x00, 0x05, 0x00};
+  t.check(!decompressBlock(before.data(), before.size(), decompressed.data(), 4), "Match before the start was decompressed");
+
+  // Any change to the block shouldn't read or write out of bounds
+  mt19937 random(7);
+  for (int i = 0; i < 2000; i++) {
+    vector<uint8_t> damaged = compressed;
+    damaged[random() % damaged.size()] = random();
+    decompressBlock(damaged.data(), damaged.size(), decompressed.data(), decompressed.size());
+  }
+
+  return t.getResult(); // Return pass or fail result
+}
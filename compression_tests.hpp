@@ -0,0 +1,29 @@
+#ifndef compression_tests_hpp
+#define compression_tests_hpp
+
+#include "compression.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool compressionTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests compressBlock() and decompressBlock() on different kinds of
+* bytes
+*/
+bool compressionTests_roundTrip();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests that decompressBlock() rejects damaged blocks
+*/
+bool compressionTests_damaged();
+
+#endif
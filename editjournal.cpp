@@ -0,0 +1,231 @@
+#include "editjournal.hpp"
+#include "savefile.hpp"
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+// Bytes every journal starts with
+static const char EDIT_JOURNAL_MAGIC[8] = {'I', 'N', 'F', 'J', 'R', 'N', 'L', '1'};
+
+/**
+* Requires: nothing
+* Modifies: filename, numRecords, and pending
+* Effects: Creates an empty journal without a file
+*/
+EditJournal::EditJournal() {
+  numRecords = 0;
+  numBytes = 0;
+  numPending = 0;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the respective field
+*/
+const string &EditJournal::getFilename() const {
+  return filename;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of records in the file plus the records that
+* haven't been flushed, or just the records that haven't been flushed
+*/
+int EditJournal::getNumRecords() const {
+  return numRecords + numPending;
+}
+int EditJournal::getNumPending() const {
+  return numPending;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of bytes used by the records in the file
+*/
+size_t EditJournal::getNumBytes() const {
+  return numBytes;
+}
+
+/**
+* Requires: a valid path for the journal file
+* Modifies: filename, numRecords, and pending
+* Effects: Switches to the journal file, dropping the records of the previous
+* one (the file is read by replay())
+*/
+void EditJournal::setFilename(const string &f) {
+  filename = f;
+  numRecords = 0;
+  numBytes = 0;
+  pending.clear();
+  numPending = 0;
+}
+
+/**
+* Requires: a non-negative column and row
+* Modifies: pending
+* Effects: Adds the change of the cell to the records waiting to be flushed
+*/
+void EditJournal::record(int column, int row, Tile tile) {
+  // Store the color itself, since palette indices change between runs
+  putVarint(pending, column);
+  putVarint(pending, row);
+  pending.push_back(static_cast<uint8_t>(tile.blockType | (tile.floorType << 4)));
+  putColor(pending, getPaletteColor(tile.colorIndex));
+  numPending++;
+}
+
+/**
+* Requires: a filename
+* Modifies: the file, numRecords, and pending
+* Effects: Appends the records waiting to be flushed to the file, returns
+* save status
+*/
+bool EditJournal::flush() {
+  if (numPending == 0) {
+    return true;
+  }
+
+  // Start a new file when there aren't any records in it yet, so an old
+  // journal is never replayed on top of a newer save
+  ofstream file(filename, ios::binary | (numRecords == 0 ? ios::trunc : ios::app));
+  if (!file) {
+    return false;
+  }
+  if (numRecords == 0) {
+    file.write(EDIT_JOURNAL_MAGIC, sizeof(EDIT_JOURNAL_MAGIC));
+  }
+  if (!file.write(reinterpret_cast<const char *>(pending.data()), pending.size()).flush()) {
+    return false;
+  }
+
+  numRecords += numPending;
+  numBytes += pending.size();
+  pending.clear();
+  numPending = 0;
+  return true;
+}
+
+/**
+* Requires: a filename
+* Modifies: changes, numRecords, and the file
+* Effects: Applies every record in the file to the changes, in order, and
+* cuts off a record that was only partly written, returns if there weren't
+* any bad records
+*/
+bool EditJournal::replay(ChangeMap &changes) {
+  numRecords = 0;
+  numBytes = 0;
+
+  // A missing journal means there weren't any edits since the save
+  ifstream file(filename, ios::binary);
+  if (!file) {
+    return true;
+  }
+  vector<uint8_t> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+  file.close();
+
+  // Apply the whole records
+  size_t used = decode(bytes.data(), bytes.size(), changes, numRecords);
+  numBytes = used > sizeof(EDIT_JOURNAL_MAGIC) ? used - sizeof(EDIT_JOURNAL_MAGIC) : 0;
+  if (used == bytes.size()) {
+    return true;
+  }
+
+  // Cut off the rest, so new records aren't appended after it
+  if (used == 0) {
+    remove(filename.c_str());
+  } else {
+    ofstream good(filename, ios::binary | ios::trunc);
+    good.write(reinterpret_cast<const char *>(bytes.data()), used);
+  }
+  return false;
+}
+
+/**
+* Requires: nothing
+* Modifies: the file, numRecords, and pending
+* Effects: Drops every record and removes the file, once they have been
+* compacted into the save
+*/
+void EditJournal::clear() {
+  if (!filename.empty()) {
+    remove(filename.c_str());
+  }
+  numRecords = 0;
+  numBytes = 0;
+  pending.clear();
+  numPending = 0;
+}
+
+/**
+* Requires: a number of records from the start of the file, and the bytes
+* they use
+* Modifies: the file, numRecords, and numBytes
+* Effects: Drops the records from the file, once they have been compacted
+* into the save, and keeps the rest
+*/
+void EditJournal::discard(int records, size_t bytes) {
+  if (records <= 0) {
+    return;
+  }
+
+  // Remove the file if every record in it was compacted
+  if (records >= numRecords || bytes >= numBytes) {
+    remove(filename.c_str());
+    numRecords = 0;
+    numBytes = 0;
+    return;
+  }
+
+  // Otherwise write a new file with the records after them
+  ifstream file(filename, ios::binary);
+  vector<uint8_t> kept(EDIT_JOURNAL_MAGIC, EDIT_JOURNAL_MAGIC + sizeof(EDIT_JOURNAL_MAGIC));
+  file.seekg(sizeof(EDIT_JOURNAL_MAGIC) + bytes);
+  kept.insert(kept.end(), istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  file.close();
+  writeFileAtomically(filename, kept.data(), kept.size());
+  numRecords -= records;
+  numBytes -= bytes;
+}
+
+/**
+* Requires: bytes in the journal layout
+* Modifies: changes
+* Effects: Applies every whole record to the changes, and returns the number
+* of bytes they used (records past the first bad one are ignored)
+*/
+size_t EditJournal::decode(const uint8_t *bytes, size_t size, ChangeMap &changes, int &numDecoded) {
+  numDecoded = 0;
+
+  // Check the header
+  if (size < sizeof(EDIT_JOURNAL_MAGIC) || memcmp(bytes, EDIT_JOURNAL_MAGIC, sizeof(EDIT_JOURNAL_MAGIC)) != 0) {
+    return 0;
+  }
+
+  // Read records until the end, or until one is cut off or bad
+  ByteReader reader = {bytes + sizeof(EDIT_JOURNAL_MAGIC), bytes + size, true};
+  const uint8_t *used = reader.next;
+  while (reader.next < reader.end) {
+    uint64_t column = reader.getVarint();
+    uint64_t row = reader.getVarint();
+    uint8_t type = reader.getByte();
+    Color color = reader.getColor();
+
+    // Make sure the change is whole, on the board, and is a wall or floor
+    Tile tile = {static_cast<uint8_t>(type & 0xF), static_cast<uint8_t>(type >> 4), 0};
+    if (!reader.isValid || column > INT_MAX || row > INT_MAX || (tile.blockType != WallBlock && tile.blockType != FloorBlock)) {
+      break;
+    }
+    tile.colorIndex = getPaletteIndex(color);
+    changes.setChange(column, row, tile);
+
+    used = reader.next;
+    numDecoded++;
+  }
+
+  return used - bytes;
+}
@@ -0,0 +1,124 @@
+#ifndef editjournal_hpp
+#define editjournal_hpp
+
+#include "changemap.hpp"
+#include "tile.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Extension added to a save's filename for its edit journal
+const string EDIT_JOURNAL_EXTENSION = ".journal";
+
+// Number of records a journal can hold before it is compacted into its save
+const int DEFAULT_JOURNAL_COMPACT_RECORDS = 4096;
+
+// Appends the cells changed since the last save to a file next to the save,
+// so saving an edit doesn't rewrite every change
+//  Note: the journal only holds changes, so it has to be replayed on top of
+//  the save it was started from
+class EditJournal {
+public:
+  /**
+  * Requires: nothing
+  * Modifies: filename, numRecords, and pending
+  * Effects: Creates an empty journal without a file
+  */
+  EditJournal();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the respective field
+  */
+  const string &getFilename() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of records in the file plus the records that
+  * haven't been flushed, or just the records that haven't been flushed
+  */
+  int getNumRecords() const;
+  int getNumPending() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of bytes used by the records in the file
+  */
+  size_t getNumBytes() const;
+
+  /**
+  * Requires: a valid path for the journal file
+  * Modifies: filename, numRecords, and pending
+  * Effects: Switches to the journal file, dropping the records of the previous
+  * one (the file is read by replay())
+  */
+  void setFilename(const string &f);
+
+  /**
+  * Requires: a non-negative column and row
+  * Modifies: pending
+  * Effects: Adds the change of the cell to the records waiting to be flushed
+  */
+  void record(int column, int row, Tile tile);
+
+  /**
+  * Requires: a filename
+  * Modifies: the file, numRecords, and pending
+  * Effects: Appends the records waiting to be flushed to the file, returns
+  * save status
+  */
+  bool flush();
+
+  /**
+  * Requires: a filename
+  * Modifies: changes, numRecords, and the file
+  * Effects: Applies every record in the file to the changes, in order, and
+  * cuts off a record that was only partly written, returns if there weren't
+  * any bad records
+  */
+  bool replay(ChangeMap &changes);
+
+  /**
+  * Requires: nothing
+  * Modifies: the file, numRecords, and pending
+  * Effects: Drops every record and removes the file, once they have been
+  * compacted into the save
+  */
+  void clear();
+
+  /**
+  * Requires: a number of records from the start of the file, and the bytes
+  * they use
+  * Modifies: the file, numRecords, and numBytes
+  * Effects: Drops the records from the file, once they have been compacted
+  * into the save, and keeps the rest
+  */
+  void discard(int records, size_t bytes);
+
+  /**
+  * Requires: bytes in the journal layout
+  * Modifies: changes
+  * Effects: Applies every whole record to the changes, and returns the number
+  * of bytes they used (records past the first bad one are ignored)
+  */
+  static size_t decode(const uint8_t *bytes, size_t size, ChangeMap &changes, int &numDecoded);
+
+private:
+  // Path of the journal file, or empty if there isn't one yet
+  string filename;
+
+  // Number of records in the file, and the bytes they use
+  int numRecords;
+  size_t numBytes;
+
+  // Records waiting to be flushed, already encoded
+  vector<uint8_t> pending;
+  int numPending;
+};
+
+#endif
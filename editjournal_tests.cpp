@@ -0,0 +1,129 @@
+#include "editjournal_tests.hpp"
+#include "floor.hpp"
+#include "wall.hpp"
+#include <fstream>
+#include <iterator>
+
+bool editJournalTests_run() {
+  cout << "Running Edit Journal Tests:" << endl;
+  cout << "---------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(editJournalTests_replay());
+  t.check(editJournalTests_damaged());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test record(), flush(), and replay()
+bool editJournalTests_replay() {
+  // Start new testing object
+  Testing t("record(), flush(), and replay()");
+
+  // Records wait in memory until they are flushed
+  EditJournal journal;
+  journal.setFilename("testing.journal");
+  journal.clear();
+  Wall customWall;
+  customWall.setColor({0.7, 0.8, 0.9});
+  journal.record(0, 0, WALL_TILE);
+  journal.record(1000000000, 4999, tileFromBlock(Floor(SandFloor)));
+  t.check(journal.getNumRecords() == 2 && journal.getNumPending() == 2 && !ifstream("testing.journal"), "Records were written before flush()");
+
+  // Flushing twice should append to the same file
+  t.check(journal.flush() && journal.getNumPending() == 0, "flush() didn't write the records");
+  journal.record(0, 0, tileFromBlock(customWall));
+  journal.record(3, 7, GRASS_TILE);
+  t.check(journal.flush() && journal.getNumRecords() == 4, "flush() didn't append the records");
+
+  // Replaying should apply the records in order, so later ones win
+  ChangeMap expected;
+  expected.setChange(0, 0, tileFromBlock(customWall));
+  expected.setChange(1000000000, 4999, tileFromBlock(Floor(SandFloor)));
+  expected.setChange(3, 7, GRASS_TILE);
+  ChangeMap changes;
+  EditJournal reopened;
+  reopened.setFilename("testing.journal");
+  t.check(reopened.replay(changes) && reopened.getNumRecords() == 4, "replay() didn't read every record");
+  t.check(changes == expected && getPaletteColor(changes.getChange(0, 0).colorIndex).g == 0.8, "replay() didn't apply the records");
+
+  // Records appended after a replay should follow the ones in the file
+  reopened.record(3, 7, WALL_TILE);
+  t.check(reopened.flush(), "flush() after replay() didn't write");
+  ChangeMap appended;
+  t.check(reopened.replay(appended) && reopened.getNumRecords() == 5 && appended.getChange(3, 7) == WALL_TILE, "Record flushed after replay() was lost");
+
+  // A missing journal has no records
+  EditJournal missing;
+  missing.setFilename("does-not-exist.journal");
+  ChangeMap none;
+  t.check(missing.replay(none) && none.empty() && missing.getNumRecords() == 0, "Missing journal had records");
+
+  reopened.clear();
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test replaying journals with a cut off or bad tail, and clear()
+bool editJournalTests_damaged() {
+  // Start new testing object
+  Testing t("replay() of damaged journals, and clear()");
+
+  // Write a few records, and keep the bytes of the file
+  EditJournal journal;
+  journal.setFilename("testing.journal");
+  journal.clear();
+  for (int row = 0; row < 3; row++) {
+    journal.record(5, row, WALL_TILE);
+  }
+  journal.flush();
+  ifstream file("testing.journal", ios::binary);
+  vector<uint8_t> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+  file.close();
+
+  // Every cut off journal should replay the whole records before the cut
+  bool replayed = true;
+  size_t recordSize = (bytes.size() - 8) / 3;
+  for (size_t size = 0; size < bytes.size(); size++) {
+    ofstream("testing.journal", ios::binary | ios::trunc).write(reinterpret_cast<const char *>(bytes.data()), size);
+    ChangeMap changes;
+    int numWhole = size < 8 ? 0 : (size - 8) / recordSize;
+    bool isWhole = size == 0 || size == 8 || (size > 8 && (size - 8) % recordSize == 0);
+    replayed = replayed && journal.replay(changes) == isWhole && changes.size() == numWhole && journal.getNumRecords() == numWhole;
+  }
+  t.check(replayed, "Cut off journal didn't replay its whole records");
+
+  // The cut off record should be removed, so the next record can be read
+  ofstream("testing.journal", ios::binary | ios::trunc).write(reinterpret_cast<const char *>(bytes.data()), bytes.size() - 1);
+  ChangeMap changes;
+  journal.replay(changes);
+  journal.record(6, 0, GRASS_TILE);
+  journal.flush();
+  changes.clear();
+  t.check(journal.replay(changes) && changes.size() == 3 && changes.getChange(6, 0) == GRASS_TILE, "Record after a cut off one was lost");
+
+  // A record that isn't a wall or floor should stop the replay
+  vector<uint8_t> badType = bytes;
+  badType[8 + 2] = 0xF;
+  ofstream("testing.journal", ios::binary | ios::trunc).write(reinterpret_cast<const char *>(badType.data()), badType.size());
+  changes.clear();
+  t.check(!journal.replay(changes) && changes.empty(), "Record with a bad type was replayed");
+
+  // Clearing should remove the file and every record
+  journal.record(1, 1, WALL_TILE);
+  journal.clear();
+  t.check(journal.getNumRecords() == 0 && !ifstream("testing.journal"), "clear() didn't remove the journal");
+
+  return t.getResult(); // Return pass or fail result
+}
@@ -0,0 +1,28 @@
+#ifndef editjournal_tests_hpp
+#define editjournal_tests_hpp
+
+#include "editjournal.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool editJournalTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests record(), flush(), and replay()
+*/
+bool editJournalTests_replay();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests replaying journals with a cut off or bad tail, and clear()
+*/
+bool editJournalTests_damaged();
+
+#endif
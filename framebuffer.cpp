@@ -0,0 +1,308 @@
+#include "framebuffer.hpp"
+#include <algorithm>
+#include <fstream>
+
+// Vector kernels are only built for x86 with GCC style target attributes
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRAMEBUFFER_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/**
+* Requires: the first pixel of the rectangle, the pixels between its rows, its
+* width and height, and a packed color
+* Modifies: the pixels
+* Effects: Fills each row of the rectangle one pixel at a time
+*/
+static void scalarKernel(uint32_t *first, int stride, int width, int height, uint32_t color) {
+  for (int row = 0; row < height; row++) {
+    uint32_t *pixel = first + static_cast<size_t>(row) * stride;
+    for (int i = 0; i < width; i++) {
+      pixel[i] = color;
+    }
+  }
+}
+
+#ifdef FRAMEBUFFER_X86_KERNELS
+/**
+* Requires: the first pixel of the rectangle, the pixels between its rows, its
+* width and height, and a packed color
+* Modifies: the pixels
+* Effects: Fills each row of the rectangle 8 pixels at a time with AVX2
+*/
+__attribute__((target("avx2"))) static void avx2Kernel(uint32_t *first, int stride, int width, int height, uint32_t color) {
+  const __m256i span = _mm256_set1_epi32(color);
+  for (int row = 0; row < height; row++) {
+    uint32_t *pixel = first + static_cast<size_t>(row) * stride;
+    int i = 0;
+    for (; i + 8 <= width; i += 8) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(pixel + i), span);
+    }
+    // Finish the row with a store that overlaps the last one, if it is wide
+    // enough, so short rows don't fall back to single pixels
+    if (i < width && width >= 8) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(pixel + width - 8), span);
+    } else {
+      for (; i < width; i++) {
+        pixel[i] = color;
+      }
+    }
+  }
+}
+
+/**
+* Requires: the first pixel of the rectangle, the pixels between its rows, its
+* width and height, and a packed color
+* Modifies: the pixels
+* Effects: Fills each row of the rectangle 4 pixels at a time with SSE2
+*/
+__attribute__((target("sse2"))) static void sse2Kernel(uint32_t *first, int stride, int width, int height, uint32_t color) {
+  const __m128i span = _mm_set1_epi32(color);
+  for (int row = 0; row < height; row++) {
+    uint32_t *pixel = first + static_cast<size_t>(row) * stride;
+    int i = 0;
+    for (; i + 4 <= width; i += 4) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(pixel + i), span);
+    }
+    if (i < width && width >= 4) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(pixel + width - 4), span);
+    } else {
+      for (; i < width; i++) {
+        pixel[i] = color;
+      }
+    }
+  }
+}
+#endif
+
+/**
+* Requires: nothing
+* Modifies: width, height, and vectorized
+* Effects: Creates an empty framebuffer
+*/
+FrameBuffer::FrameBuffer() {
+  frameWidth = 0;
+  frameHeight = 0;
+  offsetX = 0;
+  gridColumns = 0;
+  cellWidth = 0;
+  cellHeight = 0;
+  numRects = 0;
+  numFilled = 0;
+  vectorized = true;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the width or height of the frame in pixels
+*/
+int FrameBuffer::getWidth() const {
+  return frameWidth;
+}
+int FrameBuffer::getHeight() const {
+  return frameHeight;
+}
+
+/**
+* Requires: a position in the frame
+* Modifies: nothing
+* Effects: Returns the packed color of the pixel
+*/
+uint32_t FrameBuffer::getPixel(int pixelX, int pixelY) const {
+  return pixels[static_cast<size_t>(pixelY) * frameWidth + (pixelX + offsetX) % frameWidth];
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the width * height packed pixels of the frame, from the
+* left of each row
+*/
+vector<uint32_t> FrameBuffer::getPixels() const {
+  // Rotate each row of the ring back to the left edge of the frame
+  vector<uint32_t> frame(pixels.size());
+  for (int y = 0; y < frameHeight; y++) {
+    const uint32_t *row = &pixels[static_cast<size_t>(y) * frameWidth];
+    rotate_copy(row, row + offsetX, row + frameWidth, &frame[static_cast<size_t>(y) * frameWidth]);
+  }
+  return frame;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of rectangles and pixels filled since the frame
+* began (after clipping), a measure of the cost of drawing it that doesn't
+* depend on the speed of the machine
+*/
+int FrameBuffer::getNumRects() const {
+  return numRects;
+}
+long long FrameBuffer::getNumFilled() const {
+  return numFilled;
+}
+
+/**
+* Requires: nothing
+* Modifies: vectorized
+* Effects: Sets if rectangles are filled with the vector kernels when the CPU
+* supports them (the scalar kernel gives the same pixels)
+*/
+void FrameBuffer::setVectorized(bool v) {
+  vectorized = v;
+}
+
+/**
+* Requires: a positive width and height in pixels
+* Modifies: pixels, width, height, offsetX, the grid, numRects, and
+* numFilled
+* Effects: Starts a new frame of the size, which begins black
+*/
+void FrameBuffer::beginFrame(int width, int height) {
+  frameWidth = max(0, width);
+  frameHeight = max(0, height);
+  pixels.assign(static_cast<size_t>(frameWidth) * frameHeight, packColor({0, 0, 0}));
+  offsetX = 0;
+  gridColumns = 0;
+  numRects = 0;
+  numFilled = 0;
+}
+
+/**
+* Requires: a positive width and height in pixels
+* Modifies: pixels, width, height, numRects, and numFilled
+* Effects: Starts drawing over the last frame, keeping its pixels (a frame of a
+* different size is started over)
+*/
+void FrameBuffer::beginUpdate(int width, int height) {
+  if (width != frameWidth || height != frameHeight) {
+    beginFrame(width, height);
+    return;
+  }
+  numRects = 0;
+  numFilled = 0;
+}
+
+/**
+* Requires: a valid color, the pixel x and y coordinates of the top left
+* corner, and the width and height of the rectangle
+* Modifies: pixels, numRects, and numFilled
+* Effects: Fills the part of the rectangle inside the frame with the color
+*/
+void FrameBuffer::fillRect(Color c, int pixelX, int pixelY, int width, int height) {
+  // Clip the rectangle to the frame
+  int left = max(pixelX, 0);
+  int top = max(pixelY, 0);
+  int right = min(pixelX + width, frameWidth);
+  int bottom = min(pixelY + height, frameHeight);
+  if (left >= right || top >= bottom) {
+    return;
+  }
+
+  // Fill the part up to the end of the ring, then the part that wrapped
+  // around to its start
+  uint32_t color = packColor(c);
+  int ringLeft = (left + offsetX) % frameWidth;
+  int firstWidth = min(right - left, frameWidth - ringLeft);
+  fillRing(color, ringLeft, top, firstWidth, bottom - top);
+  if (firstWidth < right - left) {
+    fillRing(color, 0, top, right - left - firstWidth, bottom - top);
+    numRects--;
+  }
+}
+
+/**
+* Requires: positive numbers of columns and rows, and the positive width and
+* height of each cell in pixels
+* Modifies: pixels, width, height, offsetX, the grid, numRects, and numFilled
+* Effects: Starts a new frame that shows the grid from the first column on,
+* with every cell black (the frame is the size of the cells shown)
+*/
+void FrameBuffer::beginGrid(int numColumns, int numRows, int w, int h, int firstColumn) {
+  beginFrame(numColumns * w, numRows * h);
+  gridColumns = max(1, numColumns);
+  cellWidth = w;
+  cellHeight = h;
+  scrollGrid(firstColumn);
+}
+
+/**
+* Requires: a grid that was started
+* Modifies: offsetX, numRects, and numFilled
+* Effects: Starts a new frame that shows the grid from the first column on,
+* keeping the cells of the columns that were shown before (the cells of the
+* columns that came into view have to be set)
+*/
+void FrameBuffer::scrollGrid(int firstColumn) {
+  // Each column is always in the same slot of the ring, so the new left edge
+  // is just the slot of the first column
+  int slot = (firstColumn % gridColumns + gridColumns) % gridColumns;
+  offsetX = slot * cellWidth;
+  numRects = 0;
+  numFilled = 0;
+}
+
+/**
+* Requires: a grid that was started, a column that is shown, a row of the
+* grid, and a valid color
+* Modifies: pixels, numRects, and numFilled
+* Effects: Sets the color of the cell, which is kept for later frames
+*/
+void FrameBuffer::setCell(int column, int row, Color c) {
+  int slot = (column % gridColumns + gridColumns) % gridColumns;
+  fillRing(packColor(c), slot * cellWidth, row * cellHeight, cellWidth, cellHeight);
+}
+
+/**
+* Requires: a rectangle inside the ring (which doesn't wrap around it)
+* Modifies: pixels, numRects, and numFilled
+* Effects: Fills the rectangle with the widest kernel the CPU has
+*/
+void FrameBuffer::fillRing(uint32_t color, int ringX, int pixelY, int width, int height) {
+  numRects++;
+  numFilled += static_cast<long long>(width) * height;
+
+  uint32_t *first = &pixels[static_cast<size_t>(pixelY) * frameWidth + ringX];
+#ifdef FRAMEBUFFER_X86_KERNELS
+  if (vectorized && __builtin_cpu_supports("avx2")) {
+    avx2Kernel(first, frameWidth, width, height, color);
+    return;
+  } else if (vectorized && __builtin_cpu_supports("sse2")) {
+    sse2Kernel(first, frameWidth, width, height, color);
+    return;
+  }
+#endif
+  scalarKernel(first, frameWidth, width, height, color);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Finishes the frame (the pixels are already drawn)
+*/
+void FrameBuffer::endFrame() {
+}
+
+/**
+* Requires: a valid path to write the file to
+* Modifies: the file
+* Effects: Writes the frame as a binary PPM image, returns write status
+*/
+bool FrameBuffer::writePpm(const string &filename) const {
+  ofstream file(filename, ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  // Write the header, then the red, green, and blue bytes of each pixel
+  file << "P6\n" << frameWidth << " " << frameHeight << "\n255\n";
+  vector<char> bytes;
+  bytes.reserve(pixels.size() * 3);
+  for (uint32_t pixel : getPixels()) {
+    bytes.push_back(static_cast<char>(pixel & 0xFF));
+    bytes.push_back(static_cast<char>((pixel >> 8) & 0xFF));
+    bytes.push_back(static_cast<char>((pixel >> 16) & 0xFF));
+  }
+  return static_cast<bool>(file.write(bytes.data(), bytes.size()).flush());
+}
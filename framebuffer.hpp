@@ -0,0 +1,160 @@
+#ifndef framebuffer_hpp
+#define framebuffer_hpp
+
+#include "renderbackend.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Draws frames into pixels in memory instead of on the screen, so the board
+// can be rendered, timed, and compared on hosts without a display
+//  Note: each pixel is packed by packColor(), and rows are stored from the top.
+//  The pixels of a row are a ring, starting at offsetX, so scrolling the grid
+//  only moves the offset. Rectangles filled over the grid stay in the ring
+//  until the cells under them are set again.
+class FrameBuffer : public RenderBackend {
+public:
+  /**
+  * Requires: nothing
+  * Modifies: width, height, and vectorized
+  * Effects: Creates an empty framebuffer
+  */
+  FrameBuffer();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the width or height of the frame in pixels
+  */
+  int getWidth() const;
+  int getHeight() const;
+
+  /**
+  * Requires: a position in the frame
+  * Modifies: nothing
+  * Effects: Returns the packed color of the pixel
+  */
+  uint32_t getPixel(int pixelX, int pixelY) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the width * height packed pixels of the frame, from the
+  * left of each row
+  */
+  vector<uint32_t> getPixels() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of rectangles and pixels filled since the frame
+  * began (after clipping), a measure of the cost of drawing it that doesn't
+  * depend on the speed of the machine
+  */
+  int getNumRects() const;
+  long long getNumFilled() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: vectorized
+  * Effects: Sets if rectangles are filled with the vector kernels when the CPU
+  * supports them (the scalar kernel gives the same pixels)
+  */
+  void setVectorized(bool v);
+
+  /**
+  * Requires: a positive width and height in pixels
+  * Modifies: pixels, width, height, offsetX, the grid, numRects, and
+  * numFilled
+  * Effects: Starts a new frame of the size, which begins black
+  */
+  void beginFrame(int width, int height) override;
+
+  /**
+  * Requires: a positive width and height in pixels
+  * Modifies: pixels, width, height, numRects, and numFilled
+  * Effects: Starts drawing over the last frame, keeping its pixels (a frame of
+  * a different size is started over)
+  */
+  void beginUpdate(int width, int height) override;
+
+  /**
+  * Requires: a valid color, the pixel x and y coordinates of the top left
+  * corner, and the width and height of the rectangle
+  * Modifies: pixels, numRects, and numFilled
+  * Effects: Fills the part of the rectangle inside the frame with the color
+  */
+  void fillRect(Color c, int pixelX, int pixelY, int width, int height) override;
+
+  /**
+  * Requires: positive numbers of columns and rows, and the positive width and
+  * height of each cell in pixels
+  * Modifies: pixels, width, height, offsetX, the grid, numRects, and numFilled
+  * Effects: Starts a new frame that shows the grid from the first column on,
+  * with every cell black (the frame is the size of the cells shown)
+  */
+  void beginGrid(int numColumns, int numRows, int cellWidth, int cellHeight, int firstColumn) override;
+
+  /**
+  * Requires: a grid that was started
+  * Modifies: offsetX, numRects, and numFilled
+  * Effects: Starts a new frame that shows the grid from the first column on,
+  * keeping the cells of the columns that were shown before (the cells of the
+  * columns that came into view have to be set)
+  */
+  void scrollGrid(int firstColumn) override;
+
+  /**
+  * Requires: a grid that was started, a column that is shown, a row of the
+  * grid, and a valid color
+  * Modifies: pixels, numRects, and numFilled
+  * Effects: Sets the color of the cell, which is kept for later frames
+  */
+  void setCell(int column, int row, Color c) override;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Finishes the frame (the pixels are already drawn)
+  */
+  void endFrame() override;
+
+  /**
+  * Requires: a valid path to write the file to
+  * Modifies: the file
+  * Effects: Writes the frame as a binary PPM image, returns write status
+  */
+  bool writePpm(const string &filename) const;
+
+private:
+  // Store the pixels of the frame, its size, and the pixel of the ring each
+  // row starts at
+  vector<uint32_t> pixels;
+  int frameWidth;
+  int frameHeight;
+  int offsetX;
+
+  // Store the number of columns in the grid, and the size of its cells (the
+  // column of the grid in each slot of the ring is the one shown there)
+  int gridColumns;
+  int cellWidth;
+  int cellHeight;
+
+  // Store the work done since the frame began
+  int numRects;
+  long long numFilled;
+
+  // Store if the vector kernels are used
+  bool vectorized;
+
+  /**
+  * Requires: a rectangle inside the ring (which doesn't wrap around it)
+  * Modifies: pixels, numRects, and numFilled
+  * Effects: Fills the rectangle with the widest kernel the CPU has
+  */
+  void fillRing(uint32_t color, int ringX, int pixelY, int width, int height);
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "framebuffer_tests.hpp"
+#include <fstream>
+#include <iterator>
+
+/**
+* Requires: a frame
+* Modifies: nothing
+* Effects: Returns the FNV-1a hash of the size and pixels of the frame
+*/
+static uint64_t hashFrame(const FrameBuffer &frame) {
+  uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+      hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * 1099511628211ull;
+    }
+  };
+  add(frame.getWidth());
+  add(frame.getHeight());
+  for (uint32_t pixel : frame.getPixels()) {
+    add(pixel);
+  }
+  return hash;
+}
+
+bool framebufferTests_run() {
+  cout << "Running FrameBuffer Tests:" << endl;
+  cout << "--------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(framebufferTests_fillRect());
+  t.check(framebufferTests_grid());
+  t.check(framebufferTests_writePpm());
+  t.check(framebufferTests_golden());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test fillRect(), including clipping and rows that aren't a whole number of
+// vectors wide
+bool framebufferTests_fillRect() {
+  // Start new testing object
+  Testing t("fillRect()");
+
+  Color red = {1, 0, 0};
+  uint32_t black = packColor({0, 0, 0});
+  t.check(packColor(red) == 0xFF0000FF && packColor({0, 123 / 255.0, 12 / 255.0}) == 0xFF0C7B00, "packColor() doesn't pack the channels from the lowest byte");
+
+  // A new frame is black, and only the rectangle is filled
+  FrameBuffer frame;
+  frame.beginFrame(5, 4);
+  t.check(frame.getWidth() == 5 && frame.getHeight() == 4 && frame.getPixels() == vector<uint32_t>(20, black), "beginFrame() doesn't start a black frame");
+  frame.fillRect(red, 1, 1, 2, 2);
+  t.check(frame.getPixel(1, 1) == packColor(red) && frame.getPixel(2, 2) == packColor(red) && frame.getPixel(0, 1) == black && frame.getPixel(3, 2) == black && frame.getPixel(1, 3) == black, "fillRect() doesn't fill just the rectangle");
+
+  // Rectangles are clipped to the frame, and ones outside it are skipped
+  frame.fillRect(red, -3, -3, 4, 5);
+  frame.fillRect(red, 4, 3, 10, 10);
+  frame.fillRect(red, 6, 0, 2, 2);
+  frame.fillRect(red, 0, 0, 0, 3);
+  t.check(frame.getPixel(0, 0) == packColor(red) && frame.getPixel(0, 1) == packColor(red) && frame.getPixel(0, 2) == black && frame.getPixel(4, 3) == packColor(red) && frame.getPixels().size() == 20, "fillRect() doesn't clip to the frame");
+  t.check(frame.getNumRects() == 3 && frame.getNumFilled() == 4 + 2 + 1, "fillRect() doesn't count the work it does");
+  frame.beginFrame(5, 4);
+  t.check(frame.getNumRects() == 0 && frame.getNumFilled() == 0 && frame.getPixel(1, 1) == black, "beginFrame() doesn't reset the frame");
+
+  // The vector kernels should fill the same pixels as the scalar one for
+  // every width, including the ones with a partial vector at the end
+  bool isSame = true;
+  for (int width = 0; width <= 37 && isSame; width++) {
+    FrameBuffer vector, scalar;
+    scalar.setVectorized(false);
+    for (FrameBuffer *f : {&vector, &scalar}) {
+      f->beginFrame(41, 3);
+      f->fillRect({0, 0, 1}, 0, 0, 41, 3);
+      f->fillRect(red, 2, 1, width, 1);
+    }
+    isSame = vector.getPixels() == scalar.getPixels() && (width == 0 || (scalar.getPixel(2, 1) == packColor(red) && scalar.getPixel(1 + width, 1) == packColor(red))) && scalar.getPixel(2 + width, 1) == packColor({0, 0, 1});
+  }
+  t.check(isSame, "Vector and scalar kernels don't fill the same pixels");
+
+  return t.getResult();
+}
+
+// Test beginGrid(), scrollGrid(), and setCell()
+bool framebufferTests_grid() {
+  // Start new testing object
+  Testing t("beginGrid(), scrollGrid(), and setCell()");
+
+  Color red = {1, 0, 0};
+  Color blue = {0, 0, 1};
+  uint32_t black = packColor({0, 0, 0});
+
+  // A grid of 4x2 cells of 3x2 pixels starts black, and cells are set where
+  // their column is shown
+  FrameBuffer frame;
+  frame.beginGrid(4, 2, 3, 2, 10);
+  t.check(frame.getWidth() == 12 && frame.getHeight() == 4 && frame.getPixels() == vector<uint32_t>(48, black), "beginGrid() doesn't start a black frame of the cells");
+  frame.setCell(10, 0, red);
+  frame.setCell(13, 1, blue);
+  t.check(frame.getPixel(0, 0) == packColor(red) && frame.getPixel(2, 1) == packColor(red) && frame.getPixel(3, 0) == black && frame.getPixel(9, 2) == packColor(blue) && frame.getPixel(11, 3) == packColor(blue), "setCell() doesn't set the cell where its column is shown");
+
+  // Scrolling right moves every column left, keeping their cells, and the
+  // column that came into view is set in the slot of the one that left
+  frame.scrollGrid(11);
+  frame.setCell(14, 0, blue);
+  t.check(frame.getPixel(6, 2) == packColor(blue) && frame.getPixel(9, 0) == packColor(blue) && frame.getPixel(11, 1) == packColor(blue) && frame.getPixel(0, 0) == black && frame.getNumRects() == 1 && frame.getNumFilled() == 6, "scrollGrid() doesn't keep the columns that were shown");
+
+  // Rectangles across the end of the ring are filled on both sides of it
+  frame.fillRect(red, 2, 3, 5, 1);
+  bool isFilled = true;
+  for (int x = 0; x < 12; x++) {
+    isFilled = isFilled && (frame.getPixel(x, 3) == packColor(red)) == (x >= 2 && x < 7);
+  }
+  t.check(isFilled && frame.getNumRects() == 2 && frame.getNumFilled() == 6 + 5, "fillRect() doesn't fill across the end of the ring");
+
+  // Scrolling left moves every column right, with the columns that came into
+  // view in the slots of the ones that left
+  frame.scrollGrid(9);
+  frame.setCell(9, 0, red);
+  t.check(frame.getPixel(0, 0) == packColor(red) && frame.getPixel(2, 1) == packColor(red) && frame.getPixel(9, 0) == black && frame.getPixel(11, 1) == black, "scrollGrid() doesn't scroll left");
+
+  // A new frame starts over without the ring
+  frame.beginFrame(12, 4);
+  t.check(frame.getPixels() == vector<uint32_t>(48, black), "beginFrame() doesn't start over after a grid");
+
+  return t.getResult();
+}
+
+// Test writePpm()
+bool framebufferTests_writePpm() {
+  // Start new testing object
+  Testing t("writePpm()");
+
+  FrameBuffer frame;
+  frame.beginFrame(3, 2);
+  frame.fillRect({1, 0, 0}, 0, 0, 1, 1);
+  frame.fillRect({0, 123 / 255.0, 12 / 255.0}, 2, 1, 1, 1);
+  t.check(frame.writePpm("testing.render.ppm"), "writePpm() didn't write the file");
+
+  // The header is followed by the red, green, and blue bytes of each pixel,
+  // from the top row down
+  ifstream file("testing.render.ppm", ios::binary);
+  string bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+  string expected = string("P6\n3 2\n255\n") + string("\xFF\x00\x00", 3) + string(12, '\0') + string("\x00\x7B\x0C", 3);
+  t.check(bytes == expected, "writePpm() doesn't write a binary PPM image");
+  file.close();
+  remove("testing.render.ppm");
+
+  t.check(!frame.writePpm("testing.missing/testing.render.ppm"), "writePpm() doesn't fail when the file can't be written");
+
+  return t.getResult();
+}
+
+// Test that boards are drawn the same as the golden images
+bool framebufferTests_golden() {
+  // Start new testing object
+  Testing t("display() golden images");
+
+  // Create an object with a custom seed and one change
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  testChanges[1][2] = make_shared<Floor>();
+  GameBoard g1(3, 3, 2, 2, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
+  // Game map (P is the player):
+  // P F F
+  // W F F
+  // F F W
+
+  // Each block is 2x2 pixels, with the player on top of its floor
+  FrameBuffer frame;
+  g1.display(frame);
+  const char *golden[] = {"PPGGGG", "PPGGGG", "WWGGGG", "WWGGGG", "GGGGWW", "GGGGWW"};
+  bool matches = frame.getWidth() == 6 && frame.getHeight() == 6;
+  for (int y = 0; y < 6 && matches; y++) {
+    for (int x = 0; x < 6; x++) {
+      char cell = golden[y][x];
+      Color expected = cell == 'P' ? g1.getPlayer().getColor() : cell == 'W' ? Color{0, 0, 0} : Color{0, 123 / 255.0, 12 / 255.0};
+      matches = matches && frame.getPixel(x, y) == packColor(expected);
+    }
+  }
+  t.check(matches, "display() doesn't draw the 3x3 board like the golden image");
+  // The runs of the same color are merged into 5 rectangles (the top row,
+  // the wall on the left, the first two cells of the bottom row, the rest of
+  // the middle row, and the wall on the right), without covering any cell
+  // twice
+  t.check(frame.getNumRects() == 5 + 1 && frame.getNumFilled() == 36 + 4, "display() doesn't merge the runs of the same color");
+
+  // A larger generated board should hash to the same frame every time, with
+  // the vector and scalar kernels (the image is written when it doesn't, so
+  // it can be looked at)
+  GameBoard g2(40, 25, 3, 2, 7, 0.3, {}, LEGACY_GAME_VERSION);
+  FrameBuffer vector, scalar;
+  scalar.setVectorized(false);
+  g2.display(vector);
+  g2.display(scalar);
+  bool isGolden = hashFrame(vector) == 0x54ebb5eb78508fdfull;
+  if (!isGolden) {
+    vector.writePpm("testing.render.ppm");
+  }
+  t.check(isGolden, "display() doesn't draw the 40x25 board like the golden image (written to testing.render.ppm)");
+  t.check(vector.getPixels() == scalar.getPixels(), "display() doesn't draw the same board with the vector and scalar kernels");
+
+  return t.getResult();
+}
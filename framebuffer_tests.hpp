@@ -0,0 +1,44 @@
+#ifndef framebuffer_tests_hpp
+#define framebuffer_tests_hpp
+
+#include "framebuffer.hpp"
+#include "gameboard.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool framebufferTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests fillRect(), including clipping and rows that aren't a whole
+* number of vectors wide
+*/
+bool framebufferTests_fillRect();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests beginGrid(), scrollGrid(), and setCell()
+*/
+bool framebufferTests_grid();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests writePpm()
+*/
+bool framebufferTests_writePpm();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests that boards are drawn the same as the golden images
+*/
+bool framebufferTests_golden();
+
+#endif
@@ -1,7 +1,9 @@
 #include "gameboard.hpp"
 #include <fstream>
 #include <iostream>
+#include <chrono>
 #include <regex>
+#include <thread>
 #include <typeinfo>
 
 /**
@@ -49,9 +51,41 @@ GameBoard::GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH) {
   // Set the left edge of the display window to 0
   leftDisplayEdge = 0;
 
+  // Nothing has been drawn yet
+  isAllDamaged = true;
+  drawnDisplayEdge = 0;
+
+  // Keep the default number of columns around the display window
+  residencyWidth = DEFAULT_RESIDENCY_WIDTH;
+
+  // Generate the default number of columns in the background
+  prefetchWidth = DEFAULT_PREFETCH_WIDTH;
+
+  // Generate the board on every core
+  numGenerateThreads = 0;
+  generateSeconds = 0;
+
+  // Compact the edit journal after the default number of records
+  journalLimit = DEFAULT_JOURNAL_COMPACT_RECORDS;
+  journalSaveNumber = 0;
+  journalSaveRecords = 0;
+  journalSaveBytes = 0;
+
+  // Keep the default number of edits to undo
+  undoLimit = DEFAULT_UNDO_LIMIT;
+  isGroupingEdits = false;
+  isGroupRemembered = false;
+
+  // Only save the changes that differ from the generated tiles, and compress
+  // them
+  normalizeSaves = true;
+  compressSaves = true;
+
   // Initialize the seed to the current timestamp
   seed = time(nullptr);
-  rand.seed(seed);
+
+  // New games use the current generator
+  gameVersion = GAME_VERSION;
 
   // Initialize the percent wall
   percentWall = 0.3;
@@ -65,7 +99,7 @@ GameBoard::GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH) {
   player.setAlternateColor({1, 215 / 255.0, 0});
 
   // Set the (0,0) position to a floor
-  changes[0][0] = make_shared<Floor>();
+  changes.setChange(0, 0, GRASS_TILE);
 
   // Generate the board
   generateBoard();
@@ -76,21 +110,30 @@ GameBoard::GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH) {
 * percentWall, and changes map
 * Effects: Creates a new gameboard (used primarly for testing purposes)
 */
-GameBoard::GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH, int s, double pWall, map<int, map<int, shared_ptr<Block>>> c) : GameBoard(nBlocksWide, nBlocksHigh, blockW, blockH) {
+GameBoard::GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH, int s, double pWall, map<int, map<int, shared_ptr<Block>>> c, int gVersion) : GameBoard(nBlocksWide, nBlocksHigh, blockW, blockH) {
   // If the seed is set, use it
   if (s != 0) {
     seed = s;
-    rand.seed(seed);
   }
 
+  // Use the requested generator version
+  gameVersion = gVersion;
+
   // If the wall is set, use it
   if (pWall != -1) {
     percentWall = max(0.0, min(pWall, 1.0));
   }
 
-  // Set the changes if it is not empty
+  // Set the changes if it is not empty, storing the tile for each block
   if (!c.empty()) {
-    changes = c;
+    changes.clear();
+    for (map<int, map<int, shared_ptr<Block>>>::iterator i = c.begin(); i != c.end(); i++) {
+      for (map<int, shared_ptr<Block>>::iterator j = (i->second).begin(); j != (i->second).end(); j++) {
+        if (i->first >= 0 && j->first >= 0) {
+          changes.setChange(i->first, j->first, tileFromBlock(*j->second));
+        }
+      }
+    }
   }
 
   // Regenerate the board (since this will only be used in testing, it's fine)
@@ -120,16 +163,332 @@ int GameBoard::getSeed() const {
 double GameBoard::getPercentWall() const {
   return percentWall;
 }
-Player GameBoard::getPlayer() const {
+int GameBoard::getGameVersion() const {
+  return gameVersion;
+}
+const Player &GameBoard::getPlayer() const {
   return player;
 }
 vector<vector<shared_ptr<Block>>> GameBoard::getBoard() const {
-  return board;
+  // Build the blocks from the tiles, using the shared block for each tile
+  //  Note: columns that aren't on the board are left empty
+  vector<vector<shared_ptr<Block>>> blocks(board.getNumColumns());
+  for (TileStore::ColumnView view : getColumns()) {
+    for (int row = 0; row < numBlocksHigh; row++) {
+      blocks[view.column].push_back(sharedBlockFromTile(view.tiles[row]));
+    }
+  }
+
+  return blocks;
 }
 map<int, map<int, shared_ptr<Block>>> GameBoard::getChanges() const {
+  // Build the nested map from the changed tiles, using the shared block for
+  // each tile
+  map<int, map<int, shared_ptr<Block>>> blocks;
+  for (const ChangeMap::Change &change : changes) {
+    blocks[change.getColumn()][change.getRow()] = sharedBlockFromTile(change.tile);
+  }
+
+  return blocks;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if the column is on the board
+*/
+bool GameBoard::hasColumn(int column) const {
+  return board.hasColumn(column);
+}
+
+/**
+* Requires: a column on the board and a row within it
+* Modifies: nothing
+* Effects: Returns the tile at the position, without copying the board
+*/
+Tile GameBoard::getTile(int column, int row) const {
+  return board.getTile(column, row);
+}
+
+/**
+* Requires: a column on the board
+* Modifies: nothing
+* Effects: Returns the numBlocksHigh tiles of the column, which stay valid
+* until the board scrolls, is edited, or is generated again
+*/
+const Tile *GameBoard::getColumn(int column) const {
+  return board.getColumn(column);
+}
+
+/**
+* Requires: a column on the board and a row within it
+* Modifies: nothing
+* Effects: Returns if the player (or a wall) can be moved on top of the
+* position
+*/
+bool GameBoard::isWalkable(int column, int row) const {
+  return board.isWalkable(column, row);
+}
+
+/**
+* Requires: a column on the board
+* Modifies: nothing
+* Effects: Returns if any position in the column can be moved on top of
+*/
+bool GameBoard::hasFreeCell(int column) const {
+  return board.hasWalkableTile(column);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of walls on the board from firstColumn up to (but
+* not including) lastColumn and firstRow up to (but not including) lastRow,
+* or in the display window
+*/
+int GameBoard::countWalls(int firstColumn, int lastColumn, int firstRow, int lastRow) const {
+  return board.countWalls(firstColumn, lastColumn, firstRow, lastRow);
+}
+int GameBoard::countWallsInView() const {
+  return countWalls(leftDisplayEdge, leftDisplayEdge + numBlocksWide, 0, numBlocksHigh);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns a view of the columns on the board from first up to (but
+* not including) last, or of every column on the board
+*/
+TileStore::ColumnRange GameBoard::getColumns(int first, int last) const {
+  return board.getColumns(first, last);
+}
+TileStore::ColumnRange GameBoard::getColumns() const {
+  return board.getColumns(0, board.getNumColumns());
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the changes to the generated tiles, which can be iterated
+* over without copying them
+*/
+const ChangeMap &GameBoard::getChangeMap() const {
   return changes;
 }
 
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of columns kept on each side of the display
+* window, or the bytes used by the columns on the board
+*/
+int GameBoard::getResidencyWidth() const {
+  return residencyWidth;
+}
+size_t GameBoard::getBoardMemoryUsage() const {
+  return board.getMemoryUsage();
+}
+
+/**
+* Requires: a positive width, or 0 to keep every column
+* Modifies: residencyWidth and board
+* Effects: Sets the number of columns kept on each side of the display window
+*/
+void GameBoard::setResidencyWidth(int width) {
+  residencyWidth = max(0, width);
+  removeDistantColumns();
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of columns generated in the background past the
+* right edge of the display window
+*/
+int GameBoard::getPrefetchWidth() const {
+  return prefetchWidth;
+}
+
+/**
+* Requires: a positive width, or 0 to generate every column when it is needed
+* Modifies: prefetchWidth and prefetcher
+* Effects: Sets the number of columns generated in the background past the
+* right edge of the display window
+*/
+void GameBoard::setPrefetchWidth(int width) {
+  prefetchWidth = max(0, width);
+  startPrefetcher();
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of threads used to generate the board, or the
+* seconds the last board took to generate
+*/
+int GameBoard::getNumGenerateThreads() const {
+  return numGenerateThreads;
+}
+double GameBoard::getGenerateSeconds() const {
+  return generateSeconds;
+}
+
+/**
+* Requires: a positive number of threads, or 0 to use every core
+* Modifies: numGenerateThreads
+* Effects: Sets the number of threads used to generate the board
+*/
+void GameBoard::setNumGenerateThreads(int numThreads) {
+  numGenerateThreads = max(0, numThreads);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the edit journal of the save, or the number of records it
+* can hold before it is compacted into the save
+*/
+const EditJournal &GameBoard::getEditJournal() const {
+  return journal;
+}
+int GameBoard::getJournalLimit() const {
+  return journalLimit;
+}
+
+/**
+* Requires: a positive number of records, or 0 to always save the whole game
+* Modifies: journalLimit
+* Effects: Sets the number of records the edit journal can hold before it is
+* compacted into the save
+*/
+void GameBoard::setJournalLimit(int limit) {
+  journalLimit = max(0, limit);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if saves drop the changes that match the generated tiles
+*/
+bool GameBoard::getNormalizeSaves() const {
+  return normalizeSaves;
+}
+
+/**
+* Requires: nothing
+* Modifies: normalizeSaves
+* Effects: Sets if saves drop the changes that match the generated tiles (on
+* the writer's thread for background saves)
+*/
+void GameBoard::setNormalizeSaves(bool isNormalized) {
+  normalizeSaves = isNormalized;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if binary saves compress their chunks of changes
+*/
+bool GameBoard::getCompressSaves() const {
+  return compressSaves;
+}
+
+/**
+* Requires: nothing
+* Modifies: compressSaves
+* Effects: Sets if binary saves compress their chunks of changes (which is
+* kept in the save, and used again when it is loaded)
+*/
+void GameBoard::setCompressSaves(bool isCompressed) {
+  compressSaves = isCompressed;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of edits that can be undone
+*/
+int GameBoard::getUndoLimit() const {
+  return undoLimit;
+}
+
+/**
+* Requires: a positive number of edits, or 0 to turn off undo
+* Modifies: undoLimit and undoHistory
+* Effects: Sets the number of edits that can be undone, forgetting the oldest
+* ones past it
+*/
+void GameBoard::setUndoLimit(int limit) {
+  undoLimit = max(0, limit);
+  while (undoHistory.size() > undoLimit) {
+    undoHistory.pop_front();
+  }
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if there is an edit to undo or redo
+*/
+bool GameBoard::canUndo() const {
+  return !undoHistory.empty();
+}
+bool GameBoard::canRedo() const {
+  return !redoHistory.empty();
+}
+
+/**
+* Requires: nothing
+* Modifies: isGroupingEdits
+* Effects: Starts (or ends) a group of edits that are undone as one, such as
+* the edits made while dragging a wall
+*/
+void GameBoard::beginEditGroup() {
+  isGroupingEdits = true;
+  isGroupRemembered = false;
+}
+void GameBoard::endEditGroup() {
+  isGroupingEdits = false;
+  isGroupRemembered = false;
+}
+
+/**
+* Requires: nothing
+* Modifies: board, changes, journal, undoHistory, and redoHistory
+* Effects: Undoes the last edit (or group of edits), or redoes the last edit
+* that was undone, returns if there was one that could be
+*/
+bool GameBoard::undo() {
+  if (undoHistory.empty()) {
+    return false;
+  }
+
+  // Keep the changes the edit made (which only copies the list of chunks), so
+  // it can be redone
+  ChangeMap edited = changes;
+  if (!restoreChanges(undoHistory.back())) {
+    return false;
+  }
+  undoHistory.pop_back();
+  redoHistory.push_back(move(edited));
+  return true;
+}
+bool GameBoard::redo() {
+  if (redoHistory.empty()) {
+    return false;
+  }
+  ChangeMap undone = changes;
+  if (!restoreChanges(redoHistory.back())) {
+    return false;
+  }
+  redoHistory.pop_back();
+  undoHistory.push_back(move(undone));
+  if (undoHistory.size() > undoLimit) {
+    undoHistory.pop_front();
+  }
+  return true;
+}
+
 /**
 * Requires: nothing
 * Modifies: nothing
@@ -190,184 +549,325 @@ int GameBoard::convertPixelYToVectorY(int pixelY) const {
 * Effects: saves the game to a file
 */
 bool GameBoard::saveGame(string filename) {
-  // Keep track of save status
-  bool isSaved = true;
-
   // If filename is empty, use default filename
   if (filename.empty()) {
-    if (gameFilename.empty()) {
-      filename = to_string(seed) + ".infinity.json"; // Default seed based filename
-      gameFilename = filename;                       // Store the generated filename
-    } else {
-      filename = gameFilename; // Custom filename
-    }
+    filename = chooseGameFilename();
   }
 
-  // Open session file
-  ofstream gameFile(filename);
-  if (gameFile) {
-    // Create new json object
-    json gameJson;
-
-    // Add game version
-    gameJson["gameVersion"] = GAME_VERSION;
+  // Let the background saves finish first, so they can't replace this one
+  waitForSaves();
 
-    // Add time saved
-    gameJson["saveTime"] = time(nullptr);
+  // Drop the changes that match the generated tiles, then keep JSON saves as
+  // JSON, and write the rest in the binary layout
+  SaveData data = getSaveData();
+  if (normalizeSaves) {
+    normalizeChanges(data);
+  }
+  bool isSaved = writeSave(filename, data);
+
+  // The save now has every change, so its journal isn't needed (and would
+  // undo newer changes if it was replayed)
+  if (isSaved && filename == gameFilename) {
+    journal.clear();
+    journalSaveNumber = 0;
+  } else if (isSaved) {
+    remove((filename + EDIT_JOURNAL_EXTENSION).c_str());
+  }
 
-    // Add the game dimensions
-    gameJson["numBlocksWide"] = numBlocksWide;
-    gameJson["numBlocksHigh"] = numBlocksHigh;
-    gameJson["blockWidth"] = blockWidth;
-    gameJson["blockHeight"] = blockHeight;
+  return isSaved;
+}
 
-    // Save the left display edge
-    gameJson["leftDisplayEdge"] = leftDisplayEdge;
+/**
+* Requires: nothing
+* Modifies: the save's edit journal (or the save)
+* Effects: appends the cells changed since the last save to the save's edit
+* journal, or saves the whole game if there isn't a save yet or the journal
+* is full
+*/
+bool GameBoard::saveEdits() {
+  // Write the whole game if there isn't a save to replay the journal on
+  if (gameFilename.empty()) {
+    return saveGame();
+  }
 
-    // Add the seed
-    gameJson["seed"] = seed;
+  // Otherwise append the changed cells, and compact the journal into the save
+  // in the background once it is full
+  finishSaves();
+  bool isSaved = journal.flush();
+  if (journal.getNumRecords() > journalLimit && !isSaving()) {
+    saveGameAsync();
+  }
 
-    // Add the percentages
-    gameJson["percentWall"] = percentWall;
+  return isSaved;
+}
 
-    // Add the player
-    gameJson["player"] = player.toJson();
+/**
+* Requires: nothing
+* Modifies: saveWriter
+* Effects: takes a snapshot of the game and saves it to the game's file on a
+* background thread, joining a save that hasn't started yet
+*/
+void GameBoard::saveGameAsync() {
+  string filename = chooseGameFilename();
 
-    // Add the changes
-    for (map<int, map<int, shared_ptr<Block>>>::iterator i = changes.begin(); i != changes.end(); i++) {
-      for (map<int, shared_ptr<Block>>::iterator j = (i->second).begin(); j != (i->second).end(); j++) {
-        json object = (j->second)->toJson();   // Convert the block to JSON
-        object["column"] = i->first;           // Add the column position
-        object["row"] = j->first;              // Add the row position
-        gameJson["changes"].push_back(object); // Add to the changes json array
-      }
-    }
+  // Write the journal first, so the edits are kept even if the save never
+  // finishes
+  journal.flush();
 
-    // Save to the file in pretty print
-    gameFile << setw(4) << gameJson << endl;
-  } else {
-    // Error opening file
-    isSaved = false;
+  // Hand the snapshot to the writer, and remember the journal records it has
+  if (!saveWriter) {
+    saveWriter.reset(new SaveWriter());
   }
+  journalSaveRecords = journal.getNumRecords();
+  journalSaveBytes = journal.getNumBytes();
+  journalSaveNumber = saveWriter->requestSave(filename, getSaveData(), normalizeSaves);
+}
 
-  // Close file
-  gameFile.close();
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: returns if a background save is waiting or being written
+*/
+bool GameBoard::isSaving() const {
+  return saveWriter && saveWriter->isWriting();
+}
 
-  // Return saved status
+/**
+* Requires: nothing
+* Modifies: journal
+* Effects: waits until every background save has finished, returns if the
+* last one was written
+*/
+bool GameBoard::waitForSaves() {
+  bool isSaved = !saveWriter || saveWriter->wait();
+  finishSaves();
   return isSaved;
 }
 
+/**
+* Requires: nothing
+* Modifies: journal
+* Effects: drops the journal records that a finished background save has,
+* and returns the time the last background save was written (or 0 if none
+* has been)
+*/
+long long GameBoard::finishSaves() {
+  if (!saveWriter) {
+    return 0;
+  }
+
+  // Once the newest save is written, the records it has aren't needed
+  if (journalSaveNumber > 0 && saveWriter->getNumFinished() >= journalSaveNumber) {
+    if (saveWriter->getLastStatus()) {
+      journal.discard(journalSaveRecords, journalSaveBytes);
+    }
+    journalSaveNumber = 0;
+  }
+
+  return saveWriter->getLastStatus() ? saveWriter->getLastFinishTime() : 0;
+}
+
+/**
+* Requires: a valid path to save the file to
+* Modifies: nothing
+* Effects: saves the game to a file as JSON
+*/
+bool GameBoard::exportGame(string filename) {
+  SaveData data = getSaveData();
+  if (normalizeSaves) {
+    normalizeChanges(data);
+  }
+  return writeJsonSave(filename, data);
+}
+
 /**
 * Requires: a valid path to an existing game file
 * Modifies: all GameBoard fields
 * Effects: loads the game from a file
 */
 bool GameBoard::loadGame(string filename) {
-  // Keep track of the game load status
-  bool isLoaded = true;
+  // Let the background saves of the current game finish first
+  waitForSaves();
 
   // If filename is empty, use default filename
   if (filename.empty()) {
     filename = "game.infinity.json";
   }
 
-  // Store the filename for when we save
+  // Store the filename for when we save, along with its journal
   gameFilename = filename;
-
-  // Open game file
-  ifstream gameFile(filename);
-  if (gameFile) {
-    // Create new json object
-    json gameJson;
-
-    // Try converting file to json object
-    try {
-      gameFile >> gameJson;
-    } catch (exception e) {
-      cout << "Error converting file to json..." << endl;
-      isLoaded = false;
+  journal.setFilename(filename + EDIT_JOURNAL_EXTENSION);
+
+  // Map binary saves and decode their chunks of changes when they are needed,
+  // and read JSON saves a piece at a time
+  SaveData data;
+  if (isBinarySave(filename)) {
+    if (!openBinarySave(filename, data)) {
+      cout << "Binary save file is invalid or truncated..." << endl;
+      return false;
     }
-
-    // Load game dimensions
-    try {
-      numBlocksWide = gameJson.at("numBlocksWide").get<int>();
-      numBlocksHigh = gameJson.at("numBlocksHigh").get<int>();
-      blockWidth = gameJson.at("blockWidth").get<int>();
-      blockHeight = gameJson.at("blockHeight").get<int>();
-    } catch (exception e) {
-      cout << "Syntax invalid for save file... Error loading game dimensions..." << endl;
-      isLoaded = false;
+  } else {
+    ifstream gameFile(filename);
+    if (!gameFile) {
+      // Couldn't find file
+      return false;
+    }
+    JsonSaveReader reader(gameFile);
+    if (!reader.read(data)) {
+      cout << "Syntax invalid for save file... " << reader.getError() << "..." << endl;
+      return false;
     }
+  }
+
+  return loadSaveData(move(data));
+}
+
+/**
+* Requires: nothing
+* Modifies: gameFilename and journal
+* Effects: returns the game's filename, choosing one from the seed if it
+* doesn't have one yet
+*/
+string GameBoard::chooseGameFilename() {
+  if (gameFilename.empty()) {
+    gameFilename = to_string(seed) + BINARY_SAVE_EXTENSION; // Default seed based filename
+    journal.setFilename(gameFilename + EDIT_JOURNAL_EXTENSION);
+  }
+  return gameFilename;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: returns everything that is stored in a save file
+*/
+SaveData GameBoard::getSaveData() const {
+  // Only keep checkpoints for the height of the board
+  vector<StreamCheckpoint> checkpoints;
+  if (generator.getCheckpointRows() == numBlocksHigh) {
+    checkpoints = generator.getCheckpoints();
+  }
+
+  // Copy the chunks that were never loaded from the save as they are
+  vector<SaveChunk> chunks;
+  for (const auto &chunk : unloadedChunks) {
+    chunks.push_back(chunk.second);
+  }
+
+  // The changes are shared with the snapshot until either changes them, so
+  // background saves don't copy them on the game's thread
+  return {gameVersion, time(nullptr), numBlocksWide, numBlocksHigh, blockWidth, blockHeight, leftDisplayEdge, seed, percentWall, player, changes, checkpoints, chunks, saveFile, compressSaves};
+}
+
+/**
+* Requires: everything stored in a save file
+* Modifies: all GameBoard fields
+* Effects: loads the game from the save data, returns load status
+*/
+bool GameBoard::loadSaveData(SaveData &&data) {
+  // Make sure we know how to generate the board for this save
+  if (data.gameVersion < LEGACY_GAME_VERSION || data.gameVersion > GAME_VERSION) {
+    cout << "Save file is from an unknown game version..." << endl;
+    return false;
+  }
+
+  // Load the fields
+  gameVersion = data.gameVersion;
+  numBlocksWide = data.numBlocksWide;
+  numBlocksHigh = data.numBlocksHigh;
+  blockWidth = data.blockWidth;
+  blockHeight = data.blockHeight;
+  leftDisplayEdge = data.leftDisplayEdge;
+  seed = data.seed;
+  percentWall = data.percentWall;
+  player = data.player;
+  changes = move(data.changes);
+  damageAll();
+  undoHistory.clear();
+  redoHistory.clear();
+  isGroupRemembered = false;
+  unloadedChunks.clear();
+  for (const SaveChunk &chunk : data.unloadedChunks) {
+    unloadedChunks[chunk.chunk] = chunk;
+  }
+  saveFile = move(data.file);
+  compressSaves = data.isCompressed;
+
+  // Start the generator from the save's checkpoints
+  generator = Generator(seed, percentWall, gameVersion);
+  generator.setCheckpoints(data.checkpoints, numBlocksHigh);
 
-    // Load left display edge - defaults to 0 if not in file
-    try {
-      if (gameJson.count("leftDisplayEdge") > 0) {
-        leftDisplayEdge = gameJson.at("leftDisplayEdge").get<int>();
+  // Apply the edits made since the save was written
+  replayJournal();
+
+  // Generate the board
+  generateBoard();
+
+  return true;
+}
+
+/**
+* Requires: nothing
+* Modifies: changes and journal
+* Effects: applies the edit journal of the save to the changes
+*/
+void GameBoard::replayJournal() {
+  if (!journal.replay(changes)) {
+    cout << "Edit journal was cut off... Skipping the rest of it..." << endl;
+  }
+
+  // Load the chunks the journal changed, so every unloaded chunk is the same
+  // as in the save (and can be copied from it)
+  if (!unloadedChunks.empty()) {
+    vector<int> columns;
+    for (const ChangeMap::Change &change : changes) {
+      if (unloadedChunks.count(change.getColumn() / SAVE_CHUNK_WIDTH)) {
+        columns.push_back(change.getColumn());
       }
-    } catch (exception e) {
-      cout << "Syntax invalid for save file... Error loading left display edge..." << endl;
-      isLoaded = false;
     }
-
-    // Load game seed
-    try {
-      seed = gameJson.at("seed").get<int>();
-    } catch (exception e) {
-      cout << "Syntax invalid for save file... Error loading seed..." << endl;
-      isLoaded = false;
+    for (int column : columns) {
+      loadChunks(column, column + 1);
     }
+  }
+}
 
-    // Create random object using the seed
-    rand.seed(seed);
+/**
+* Requires: nothing
+* Modifies: changes and unloadedChunks
+* Effects: loads the chunks of changes from the save for the columns from
+* firstColumn up to (but not including) lastColumn
+*/
+void GameBoard::loadChunks(int firstColumn, int lastColumn) {
+  static_assert(SAVE_CHUNK_WIDTH % CHANGE_CHUNK_WIDTH == 0, "Chunks of a save must hold whole chunks of changes");
+  if (unloadedChunks.empty() || lastColumn <= firstColumn) {
+    return;
+  }
 
-    // Load board percentages
-    try {
-      percentWall = gameJson.at("percentWall").get<double>();
-    } catch (exception e) {
-      cout << "Syntax invalid for save file... Error loading percentages..." << endl;
-      isLoaded = false;
+  // Decode each unloaded chunk in the range, keeping newer changes
+  map<int, SaveChunk>::iterator chunk = unloadedChunks.lower_bound(max(firstColumn, 0) / SAVE_CHUNK_WIDTH);
+  while (chunk != unloadedChunks.end() && chunk->first <= (lastColumn - 1) / SAVE_CHUNK_WIDTH) {
+    if (!decodeSaveChunk(*saveFile, chunk->second, changes)) {
+      cout << "Save file has a bad chunk of changes... Skipping the rest of it..." << endl;
     }
 
-    // Load player
-    try {
-      player.fromJson(gameJson.at("player"));
-    } catch (exception e) {
-      cout << "Syntax invalid for save file... Error loading player..." << endl;
-      isLoaded = false;
+    // The changes stored for undo and redo were all taken while the chunk
+    // was unloaded, so they don't have any changes in it and can share the
+    // loaded ones
+    int chunkColumn = chunk->first * SAVE_CHUNK_WIDTH;
+    for (ChangeMap &undone : undoHistory) {
+      undone.shareColumns(changes, chunkColumn, chunkColumn + SAVE_CHUNK_WIDTH);
     }
-
-    // Load changed blocks
-    try {
-      for (json::iterator change = gameJson["changes"].begin(); change != gameJson["changes"].end(); change++) {
-        // Create the type of block
-        switch (change->at("type").get<int>()) {
-        case WallBlock:
-          changes[change->at("column").get<int>()][change->at("row").get<int>()] = make_shared<Wall>();
-          break;
-        case FloorBlock:
-          changes[change->at("column").get<int>()][change->at("row").get<int>()] = make_shared<Floor>();
-          break;
-        }
-        // Load the data into the block
-        changes[change->at("column").get<int>()][change->at("row").get<int>()]->fromJson(*change);
-      }
-
-      // Generate the board
-      generateBoard();
-    } catch (exception e) {
-      cout << "Syntax invalid for save file... Error loading changed blocks..." << endl;
-      isLoaded = false;
+    for (ChangeMap &redone : redoHistory) {
+      redone.shareColumns(changes, chunkColumn, chunkColumn + SAVE_CHUNK_WIDTH);
     }
-  } else {
-    // Couldn't find file
-    isLoaded = false;
-  }
 
-  // Close file
-  gameFile.close();
+    chunk = unloadedChunks.erase(chunk);
+  }
 
-  // Return loaded result
-  return isLoaded;
+  // Let go of the save once every chunk is loaded
+  if (unloadedChunks.empty()) {
+    saveFile.reset();
+  }
 }
 
 /**
@@ -376,31 +876,61 @@ bool GameBoard::loadGame(string filename) {
 * Effects: moves the player in the direction specified
 */
 void GameBoard::movePlayer(GameDirection direction) {
-  if (direction == DIR_LEFT && player.getVectorX() > leftDisplayEdge && board[player.getVectorX() - 1][player.getVectorY()]->canMoveOnTop()) {
+  int lastX = player.getVectorX();
+  int lastY = player.getVectorY();
+
+  if (direction == DIR_LEFT && player.getVectorX() > leftDisplayEdge && board.isWalkable(player.getVectorX() - 1, player.getVectorY())) {
     // We can move to the left (no edge or wall blocking)
     if (((player.getVectorX() - leftDisplayEdge) / (double)numBlocksWide < 0.25 || player.getVectorX() - leftDisplayEdge == 1) && leftDisplayEdge > 0) {
       // Scroll board
       leftDisplayEdge--;
+      // Generate the column we scrolled to if it isn't on the board, along with
+      // the columns before it in its chunk (in order, so legacy games only
+      // replay the stream once per chunk)
+      if (!board.hasColumn(leftDisplayEdge)) {
+        for (int column = leftDisplayEdge - leftDisplayEdge % TILE_CHUNK_WIDTH; column <= leftDisplayEdge; column++) {
+          if (!board.hasColumn(column)) {
+            generateColumn(column);
+          }
+        }
+      }
+      // Drop the columns that are now far to the right
+      removeDistantColumns();
     }
     // Move player to the left
     player.setVectorX(player.getVectorX() - 1);
-  } else if (direction == DIR_RIGHT && player.getVectorX() < board.size() - 1 && board[player.getVectorX() + 1][player.getVectorY()]->canMoveOnTop()) {
+  } else if (direction == DIR_RIGHT && board.hasColumn(player.getVectorX() + 1) && board.isWalkable(player.getVectorX() + 1, player.getVectorY())) {
     // We can move to the right (no edge or wall blocking)
     if ((leftDisplayEdge + numBlocksWide - 1 - player.getVectorX()) / (double)numBlocksWide < 0.25 || leftDisplayEdge + numBlocksWide - 1 - player.getVectorX() == 1) {
       // Scroll board
       leftDisplayEdge++;
-      // Generate an extra column
-      generateColumn();
+      // Generate the column that scrolled into view if it isn't on the board,
+      // and have the background generator keep working past it
+      if (!board.hasColumn(leftDisplayEdge + numBlocksWide)) {
+        generateColumn(leftDisplayEdge + numBlocksWide);
+        if (prefetcher) {
+          prefetcher->setEdge(leftDisplayEdge + numBlocksWide + 1);
+        }
+      }
+      // Drop the columns that are now far to the left
+      removeDistantColumns();
     }
     // Move player to the right
     player.setVectorX(player.getVectorX() + 1);
-  } else if (direction == DIR_UP && player.getVectorY() > 0 && board[player.getVectorX()][player.getVectorY() - 1]->canMoveOnTop()) {
+  } else if (direction == DIR_UP && player.getVectorY() > 0 && board.isWalkable(player.getVectorX(), player.getVectorY() - 1)) {
     // We can move up (no edge or wall blocking)
     player.setVectorY(player.getVectorY() - 1);
-  } else if (direction == DIR_DOWN && player.getVectorY() < numBlocksHigh - 1 && board[player.getVectorX()][player.getVectorY() + 1]->canMoveOnTop()) {
+  } else if (direction == DIR_DOWN && player.getVectorY() < numBlocksHigh - 1 && board.isWalkable(player.getVectorX(), player.getVectorY() + 1)) {
     // We can move down (no edge or wall blocking)
     player.setVectorY(player.getVectorY() + 1);
   }
+
+  // Redraw the cells the player left and entered (the columns that scrolled
+  // into view are drawn by redraw())
+  if (player.getVectorX() != lastX || player.getVectorY() != lastY) {
+    damageCell(lastX, lastY);
+    damageCell(player.getVectorX(), player.getVectorY());
+  }
 }
 
 /**
@@ -410,6 +940,7 @@ void GameBoard::movePlayer(GameDirection direction) {
  */
 void GameBoard::swapPlayerColor() {
   player.swapColor();
+  damageCell(player.getVectorX(), player.getVectorY());
 }
 
 /**
@@ -418,12 +949,20 @@ void GameBoard::swapPlayerColor() {
  * Effects: change the floor type
  */
 void GameBoard::changeFloorTypeUnderPlayer(FloorType f) {
+  int column = player.getVectorX();
+  int row = player.getVectorY();
+
   // If the block below the player is a floor
-  if (board[player.getVectorX()][player.getVectorY()]->getBlockType() == FloorBlock) {
-    // Change the floor type (need to cast to a floor pointer first)
-    dynamic_pointer_cast<Floor>(board[player.getVectorX()][player.getVectorY()])->setFloorType(f);
-    // Update the changes map at that location with the changed floor
-    changes[player.getVectorX()][player.getVectorY()] = board[player.getVectorX()][player.getVectorY()];
+  if (board.getTile(column, row).blockType == FloorBlock) {
+    // Blocks are shared, so never change one in place - switch the location to
+    // the block for the new floor's tile instead
+    Tile floor = tileFromBlock(Floor(f));
+
+    // Update the changes map and board at that location with the changed floor
+    rememberEdit();
+    changes.setChange(column, row, floor);
+    journal.record(column, row, floor);
+    setBoardTile(column, row, floor);
   }
 }
 
@@ -441,7 +980,7 @@ bool GameBoard::moveWall(int lastX, int lastY, int currentX, int currentY) {
   int currentVectorY = convertPixelYToVectorY(currentY);
 
   // Make sure all the coordinates are within the board
-  if (lastVectorX >= board.size() || lastVectorY >= getNumBlocksHigh() || currentVectorX >= board.size() || currentVectorY >= getNumBlocksHigh()) {
+  if (!board.hasColumn(lastVectorX) || lastVectorY >= getNumBlocksHigh() || !board.hasColumn(currentVectorX) || currentVectorY >= getNumBlocksHigh()) {
     return false;
   }
 
@@ -451,12 +990,12 @@ bool GameBoard::moveWall(int lastX, int lastY, int currentX, int currentY) {
   }
 
   // Make sure the old location is a wall
-  if (board[lastVectorX][lastVectorY]->getBlockType() != WallBlock) {
+  if (board.isWalkable(lastVectorX, lastVectorY)) {
     return false;
   }
 
   // Make sure we can move on top of the new location
-  if (!board[currentVectorX][currentVectorY]->canMoveOnTop()) {
+  if (!board.isWalkable(currentVectorX, currentVectorY)) {
     return false;
   }
 
@@ -465,19 +1004,19 @@ bool GameBoard::moveWall(int lastX, int lastY, int currentX, int currentY) {
     return false;
   }
 
-  // Create the floor to replace the wall
-  shared_ptr<Block> floor = make_shared<Floor>();
-
-  // Grab the pointer to the wall
-  shared_ptr<Block> wall = board[lastVectorX][lastVectorY];
+  // Grab the wall's tile
+  Tile wall = board.getTile(lastVectorX, lastVectorY);
 
   // Save the changes
-  changes[lastVectorX][lastVectorY] = floor;
-  changes[currentVectorX][currentVectorY] = wall;
+  rememberEdit();
+  changes.setChange(lastVectorX, lastVectorY, GRASS_TILE);
+  changes.setChange(currentVectorX, currentVectorY, wall);
+  journal.record(lastVectorX, lastVectorY, GRASS_TILE);
+  journal.record(currentVectorX, currentVectorY, wall);
 
   // Update the board
-  board[lastVectorX][lastVectorY] = floor;
-  board[currentVectorX][currentVectorY] = wall;
+  setBoardTile(currentVectorX, currentVectorY, wall);
+  setBoardTile(lastVectorX, lastVectorY, GRASS_TILE);
 
   return true;
 }
@@ -494,12 +1033,12 @@ bool GameBoard::addWall(int pixelX, int pixelY) {
   int vectorY = convertPixelYToVectorY(pixelY);
 
   // Make sure all the coordinates are within the board
-  if (vectorX >= board.size() || vectorY >= getNumBlocksHigh()) {
+  if (!board.hasColumn(vectorX) || vectorY >= getNumBlocksHigh()) {
     return false;
   }
 
   // Make sure we can move on top of the new location
-  if (!board[vectorX][vectorY]->canMoveOnTop()) {
+  if (!board.isWalkable(vectorX, vectorY)) {
     return false;
   }
 
@@ -508,14 +1047,13 @@ bool GameBoard::addWall(int pixelX, int pixelY) {
     return false;
   }
 
-  // Create the wall
-  shared_ptr<Block> wall = make_shared<Wall>();
-
   // Save the changes
-  changes[vectorX][vectorY] = wall;
+  rememberEdit();
+  changes.setChange(vectorX, vectorY, WALL_TILE);
+  journal.record(vectorX, vectorY, WALL_TILE);
 
   // Update the board
-  board[vectorX][vectorY] = wall;
+  setBoardTile(vectorX, vectorY, WALL_TILE);
 
   return true;
 }
@@ -532,43 +1070,257 @@ bool GameBoard::removeWall(int pixelX, int pixelY) {
   int vectorY = convertPixelYToVectorY(pixelY);
 
   // Make sure all the coordinates are within the board
-  if (vectorX >= board.size() || vectorY >= getNumBlocksHigh()) {
+  if (!board.hasColumn(vectorX) || vectorY >= getNumBlocksHigh()) {
     return false;
   }
 
   // Make sure the block is a wall
-  if (board[vectorX][vectorY]->getBlockType() != WallBlock) {
+  if (board.isWalkable(vectorX, vectorY)) {
     return false;
   }
 
-  // Create the floor
-  shared_ptr<Block> floor = make_shared<Floor>();
-
   // Save the changes
-  changes[vectorX][vectorY] = floor;
+  rememberEdit();
+  changes.setChange(vectorX, vectorY, GRASS_TILE);
+  journal.record(vectorX, vectorY, GRASS_TILE);
 
   // Update the board
-  board[vectorX][vectorY] = floor;
+  setBoardTile(vectorX, vectorY, GRASS_TILE);
 
   return true;
 }
 
 /**
 * Requires: nothing
-* Modifies: nothing
+* Modifies: displayBatch and displayMesh
 * Effects: Displays the board to the screen
 */
 void GameBoard::display() const {
-  // Loop through the board to draw each block
+  // Draw the whole board with one draw call
+  display(displayBatch);
+}
+
+/**
+* Requires: nothing
+* Modifies: the backend and displayMesh
+* Effects: Draws the board and player as one frame of the backend, the size
+* of the game in pixels, filling one rectangle for each run of cells with the
+* same color
+*/
+void GameBoard::display(RenderBackend &backend) const {
+  // Fill the merged rectangles of each chunk in the display window, cut to
+  // the window
+  backend.beginFrame(getGamePixelWidth(), getGamePixelHeight());
+  int rightDisplayEdge = leftDisplayEdge + numBlocksWide;
+  for (int chunk = leftDisplayEdge / TILE_CHUNK_WIDTH; chunk <= (rightDisplayEdge - 1) / TILE_CHUNK_WIDTH; chunk++) {
+    for (const TileMesh::Rect &rect : displayMesh.getChunk(board, chunk)) {
+      int first = max(rect.column, leftDisplayEdge);
+      int last = min(rect.column + rect.width, rightDisplayEdge);
+      if (first < last) {
+        backend.fillRect(getPaletteColor(rect.colorIndex), convertVectorXToPixelX(first - leftDisplayEdge), convertVectorYToPixelY(rect.row), (last - first) * getBlockWidth(), rect.height * getBlockHeight());
+      }
+    }
+  }
+
+  // Fill the player (last so it is on top)
+  backend.fillRect(player.getColor(), convertVectorXToPixelX(player.getVectorX() - leftDisplayEdge), convertVectorYToPixelY(player.getVectorY()), getBlockWidth(), getBlockHeight());
+  backend.endFrame();
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if any cell in the display window changed since the board
+* was last redrawn
+*/
+bool GameBoard::hasDamage() const {
+  return isAllDamaged || !damagedCells.empty() || leftDisplayEdge != drawnDisplayEdge;
+}
+
+/**
+* Requires: nothing
+* Modifies: damagedCells and isAllDamaged
+* Effects: Marks the whole display window to be redrawn (like when what was
+* drawn before is gone)
+*/
+void GameBoard::damageAll() {
+  isAllDamaged = true;
+  damagedCells.clear();
+}
+
+/**
+* Requires: the frame the board was last drawn into (or the screen)
+* Modifies: the backend, displayBatch, damagedCells, isAllDamaged, and
+* drawnDisplayEdge
+* Effects: Draws just the cells that changed since the last redraw into the
+* backend's grid (or every cell if they all did), scrolling it by the columns
+* the display window moved so only the columns that came into view are drawn,
+* and returns the number of cells drawn
+*/
+int GameBoard::redraw() {
+  return redraw(displayBatch);
+}
+int GameBoard::redraw(RenderBackend &backend) {
+  int numDrawn = 0;
+  int first = 0;
+  int last = 0;
+  if (isAllDamaged) {
+    // Set every cell of a new grid
+    backend.beginGrid(numBlocksWide, numBlocksHigh, blockWidth, blockHeight, leftDisplayEdge);
+    for (int column = leftDisplayEdge; column < leftDisplayEdge + numBlocksWide; column++) {
+      numDrawn += drawColumn(backend, column);
+    }
+  } else if (leftDisplayEdge != drawnDisplayEdge) {
+    // Scroll the grid, and set just the columns that came into view
+    backend.scrollGrid(leftDisplayEdge);
+    first = max(leftDisplayEdge, leftDisplayEdge > drawnDisplayEdge ? drawnDisplayEdge + numBlocksWide : leftDisplayEdge);
+    last = min(leftDisplayEdge + numBlocksWide, leftDisplayEdge > drawnDisplayEdge ? leftDisplayEdge + numBlocksWide : drawnDisplayEdge);
+    for (int column = first; column < last; column++) {
+      numDrawn += drawColumn(backend, column);
+    }
+  } else if (!damagedCells.empty()) {
+    // Draw over the last frame
+    backend.beginUpdate(getGamePixelWidth(), getGamePixelHeight());
+  } else {
+    return 0;
+  }
+
+  // Set each changed cell in the display window once (the columns that were
+  // just set already have the new tiles)
+  sort(damagedCells.begin(), damagedCells.end());
+  damagedCells.erase(unique(damagedCells.begin(), damagedCells.end()), damagedCells.end());
+  for (const pair<int, int> &cell : damagedCells) {
+    bool isSet = cell.first >= first && cell.first < last;
+    if (cell.first >= leftDisplayEdge && cell.first < leftDisplayEdge + numBlocksWide && cell.second < numBlocksHigh && !isSet) {
+      backend.setCell(cell.first, cell.second, getPaletteColor(board.getTile(cell.first, cell.second).colorIndex));
+      numDrawn++;
+    }
+  }
+
+  // Fill the player over its cell
+  backend.fillRect(player.getColor(), convertVectorXToPixelX(player.getVectorX() - leftDisplayEdge), convertVectorYToPixelY(player.getVectorY()), getBlockWidth(), getBlockHeight());
+  backend.endFrame();
+
+  damagedCells.clear();
+  isAllDamaged = false;
+  drawnDisplayEdge = leftDisplayEdge;
+  return numDrawn;
+}
+
+/**
+* Requires: nothing
+* Modifies: undoHistory and redoHistory
+* Effects: stores the changes before an edit so it can be undone, unless it is
+* part of a group of edits whose changes are already stored
+*/
+void GameBoard::rememberEdit() {
+  if (isGroupRemembered) {
+    return;
+  }
+  isGroupRemembered = isGroupingEdits;
+
+  // Storing the changes only copies their list of chunks, and the edit then
+  // copies the chunk it changes
+  redoHistory.clear();
+  if (undoLimit > 0) {
+    undoHistory.push_back(changes);
+    if (undoHistory.size() > undoLimit) {
+      undoHistory.pop_front();
+    }
+  }
+}
+
+/**
+* Requires: a column in the display window, and a grid that shows it
+* Modifies: the backend
+* Effects: sets every cell of the column in the grid, and returns the number
+* of cells set
+*/
+int GameBoard::drawColumn(RenderBackend &backend, int column) const {
+  const Tile *tiles = board.getColumn(column);
   for (int row = 0; row < numBlocksHigh; row++) {
-    for (int column = 0; column < numBlocksWide; column++) {
-      // Draw the block
-      board[column + leftDisplayEdge][row]->draw(convertVectorXToPixelX(column), convertVectorYToPixelY(row), getBlockWidth(), getBlockHeight());
+    backend.setCell(column, row, getPaletteColor(tiles[row].colorIndex));
+  }
+  return numBlocksHigh;
+}
+
+/**
+* Requires: a cell on the board, and its new tile
+* Modifies: board, displayMesh, damagedCells, and isAllDamaged
+* Effects: sets the tile of the cell, marking it to be redrawn and its chunk
+* to be merged again
+*/
+void GameBoard::setBoardTile(int column, int row, Tile tile) {
+  board.setTile(column, row, tile);
+  displayMesh.invalidateColumn(column);
+  damageCell(column, row);
+}
+
+/**
+* Requires: a cell on the board
+* Modifies: damagedCells and isAllDamaged
+* Effects: marks the cell to be redrawn, or the whole display window once
+* redrawing the cells one at a time would cost more than that
+*/
+void GameBoard::damageCell(int column, int row) {
+  if (isAllDamaged) {
+    return;
+  }
+  if ((damagedCells.size() + 1) * DAMAGE_ALL_FRACTION > static_cast<size_t>(numBlocksWide) * numBlocksHigh) {
+    damageAll();
+    return;
+  }
+  damagedCells.push_back({column, row});
+}
+
+/**
+* Requires: changes from before or after an edit
+* Modifies: board, changes, and journal
+* Effects: switches to the changes, updating the positions that differ on the
+* board and in the journal, returns if it did (it doesn't if a wall would be
+* put on top of the player)
+*/
+bool GameBoard::restoreChanges(const ChangeMap &restored) {
+  // Only the chunks the edits changed can differ
+  vector<uint64_t> keys = changes.getDifferentKeys(restored);
+
+  // Find the tile at each position afterwards, which is the generated tile if
+  // it won't have a change
+  vector<Tile> tiles(keys.size());
+  vector<uint64_t> wallBits;
+  int wallColumn = -1;
+  for (int i = 0; i < keys.size(); i++) {
+    int column = ChangeMap::unpackColumn(keys[i]);
+    int row = ChangeMap::unpackRow(keys[i]);
+    if (restored.hasChange(column, row)) {
+      tiles[i] = restored.getChange(column, row);
+    } else {
+      if (column != wallColumn) {
+        generator.generateColumn(column, numBlocksHigh, wallBits);
+        wallColumn = column;
+      }
+      tiles[i] = (wallBits[row / 64] & (1ULL << (row % 64))) ? WALL_TILE : GRASS_TILE;
+    }
+
+    // Make sure a wall isn't put on top of the player
+    if (column == player.getVectorX() && row == player.getVectorY() && !tiles[i].canMoveOnTop()) {
+      return false;
     }
   }
 
-  // Draw the player (draw last so it is on top)
-  player.draw(convertVectorXToPixelX(player.getVectorX() - leftDisplayEdge), convertVectorYToPixelY(player.getVectorY()), getBlockWidth(), getBlockHeight());
+  // Switch to the changes, and record the positions in the journal (as the
+  // tile itself, since it can't remove a change) and on the board
+  changes = restored;
+  for (int i = 0; i < keys.size(); i++) {
+    int column = ChangeMap::unpackColumn(keys[i]);
+    int row = ChangeMap::unpackRow(keys[i]);
+    journal.record(column, row, tiles[i]);
+    if (board.hasColumn(column)) {
+      setBoardTile(column, row, tiles[i]);
+    }
+  }
+
+  return true;
 }
 
 /**
@@ -577,40 +1329,166 @@ void GameBoard::display() const {
 * Effects: generates the board based on the seed
 */
 void GameBoard::generateBoard() {
-  // Clear the current board
-  board.clear();
+  // Time how long the board takes to generate
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+  // Clear the current board, and stop generating columns for it in the
+  // background
+  board.clear(numBlocksHigh);
+  displayMesh.clear();
+  prefetcher.reset();
+
+  // Start a new generator, since the seed, percent wall, or version may have
+  // changed, keeping the checkpoints of the stream if the seed didn't
+  vector<StreamCheckpoint> checkpoints = generator.getCheckpoints();
+  int checkpointRows = generator.getCheckpointRows();
+  bool isSameStream = generator.getSeed() == seed;
+  generator = Generator(seed, percentWall, gameVersion);
+  if (isSameStream) {
+    generator.setCheckpoints(checkpoints, checkpointRows);
+  }
 
   // Generate enough columns to display past the player and the right edge
-  for (int column = 0; column < max(player.getVectorX(), leftDisplayEdge) + numBlocksWide + 1; column++) {
-    generateColumn();
+  int numColumns = max(player.getVectorX(), leftDisplayEdge) + numBlocksWide + 1;
+
+  // Columns left of the display window (and player) are only generated when
+  // we scroll back to them (legacy generators start from the closest
+  // checkpoint of their stream instead of replaying every column)
+  int firstColumn = min(player.getVectorX(), leftDisplayEdge);
+
+  // Load the saved changes for the columns first, since they can't be loaded
+  // from other threads
+  loadChunks(firstColumn, numColumns);
+
+  // Use every core unless the number of threads was set
+  int numThreads = numGenerateThreads;
+  if (numThreads == 0) {
+    numThreads = max(1U, thread::hardware_concurrency());
   }
+
+  if (generator.isRandomAccess() && numThreads > 1 && static_cast<long long>(numColumns - firstColumn) * numBlocksHigh >= PARALLEL_GENERATE_TILES) {
+    // Add the columns to the board up front, since only their tiles can be
+    // filled in from other threads
+    vector<Tile *> columnTiles;
+    for (int column = firstColumn; column < numColumns; column++) {
+      columnTiles.push_back(board.addColumn(column));
+    }
+
+    // Split the columns into one contiguous range per thread, each with its own
+    // copy of the generator
+    vector<thread> workers;
+    int numPerThread = (columnTiles.size() + numThreads - 1) / numThreads;
+    for (int first = 0; first < columnTiles.size(); first += numPerThread) {
+      int last = min(first + numPerThread, static_cast<int>(columnTiles.size()));
+      workers.emplace_back([this, &columnTiles, firstColumn, first, last]() {
+        Generator workerGenerator = generator;
+        for (int i = first; i < last; i++) {
+          fillColumn(firstColumn + i, columnTiles[i], workerGenerator);
+        }
+      });
+    }
+    for (thread &worker : workers) {
+      worker.join();
+    }
+  } else {
+    for (int column = firstColumn; column < numColumns; column++) {
+      generateColumn(column);
+    }
+  }
+
+  // Drop the columns far from the display window
+  removeDistantColumns();
+
+  // Generate the columns past the board in the background
+  startPrefetcher();
+
+  generateSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 }
 
 /**
-* Requires: nothing
+* Requires: a non-negative column
 * Modifies: board
-* Effects: generates a new column for the board based on the seed
+* Effects: generates the column of the board based on the seed, growing the
+* board if needed
 */
-void GameBoard::generateColumn() {
-  // Create a new column
-  board.push_back(vector<shared_ptr<Block>>());
-
-  // The column number is the size of the board
-  int column = board.size() - 1;
+void GameBoard::generateColumn(int column) {
+  // Load the saved changes for the column if they haven't been yet
+  loadChunks(column, column + 1);
+
+  // Add the column to the board (its chunk has to be merged again)
+  Tile *tiles = board.addColumn(column);
+  displayMesh.invalidateColumn(column);
+
+  // Use the column from the background generator if it is ready, otherwise
+  // generate it
+  if (prefetcher && prefetcher->takeColumn(column, tiles)) {
+    applyChanges(column, tiles);
+    board.updateWalkable(column);
+  } else {
+    fillColumn(column, tiles, generator);
+  }
+}
 
-  // Add rows to the column
+/**
+* Requires: a non-negative column, its tiles, and a random access generator
+* (or the board's generator)
+* Modifies: tiles and the column's walkability on the board
+* Effects: fills in the tiles of the column from the generator and changes
+*/
+void GameBoard::fillColumn(int column, Tile *tiles, Generator &columnGenerator) {
+  // Generate which rows of the column are walls and fill in its tiles
+  vector<uint64_t> wallBits;
+  columnGenerator.generateColumn(column, numBlocksHigh, wallBits);
   for (int row = 0; row < numBlocksHigh; row++) {
-    // If there is an existing block for here in the changes map, use it
-    if (changes.find(column) != changes.end() && changes[column].find(row) != changes[column].end()) {
-      board[column].push_back(changes[column][row]); // Add to the board
-      dist(rand);                                    // Eat the random value for this location
-    } else {
-      // Randomly create a new block for the board
-      if (dist(rand) <= percentWall) {
-        board[column].push_back(make_shared<Wall>());
-      } else {
-        board[column].push_back(make_shared<Floor>());
+    tiles[row] = (wallBits[row / 64] & (1ULL << (row % 64))) ? WALL_TILE : GRASS_TILE;
+  }
+
+  applyChanges(column, tiles);
+  board.updateWalkable(column);
+}
+
+/**
+* Requires: a non-negative column and its tiles
+* Modifies: tiles
+* Effects: replaces the tiles of the column that have changes
+*/
+void GameBoard::applyChanges(int column, Tile *tiles) const {
+  // Use the changed tiles from the changes map, checking the column's presence
+  // bits so rows without a change only cost a bit test
+  const vector<uint64_t> *changedRows = changes.getColumnBits(column);
+  if (changedRows) {
+    for (int row = 0; row < numBlocksHigh && row / 64 < changedRows->size(); row++) {
+      if (((*changedRows)[row / 64] >> (row % 64)) & 1) {
+        tiles[row] = changes.getChange(column, row);
       }
     }
   }
 }
+
+/**
+* Requires: nothing
+* Modifies: prefetcher
+* Effects: restarts the background generator past the right edge of the board
+*/
+void GameBoard::startPrefetcher() {
+  // Stop the old generator, since the seed, version, or height may have changed
+  prefetcher.reset();
+
+  // Legacy columns come from one stream in order, so they can't be generated
+  // ahead on another thread
+  if (prefetchWidth > 0 && generator.isRandomAccess()) {
+    prefetcher = make_unique<ColumnPrefetcher>(generator, numBlocksHigh, prefetchWidth, leftDisplayEdge + numBlocksWide + 1);
+  }
+}
+
+/**
+* Requires: nothing
+* Modifies: board and displayMesh
+* Effects: drops the columns outside the residency width of the display window
+*/
+void GameBoard::removeDistantColumns() {
+  if (residencyWidth > 0) {
+    board.removeChunksOutside(leftDisplayEdge - residencyWidth, leftDisplayEdge + numBlocksWide + residencyWidth);
+    displayMesh.removeChunksOutside(leftDisplayEdge - residencyWidth, leftDisplayEdge + numBlocksWide + residencyWidth);
+  }
+}
\ No newline at end of file
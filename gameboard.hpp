@@ -2,16 +2,45 @@
 #define gameboard_hpp
 
 #include "block.hpp"
+#include "changemap.hpp"
+#include "columnprefetcher.hpp"
+#include "editjournal.hpp"
 #include "floor.hpp"
+#include "generator.hpp"
+#include "jsonsavereader.hpp"
+#include "savefile.hpp"
+#include "savewriter.hpp"
 #include "player.hpp"
+#include "quadbatch.hpp"
+#include "tilemesh.hpp"
+#include "tilestore.hpp"
 #include "wall.hpp"
+#include <deque>
 #include <map>
 #include <memory>
 #include <random>
 #include <vector>
 
 // Game version (to keep track of save files)
-const int GAME_VERSION = 1;
+const int GAME_VERSION = VECTOR_GAME_VERSION;
+
+// Number of columns kept on each side of the display window before they are
+// dropped from the board
+const int DEFAULT_RESIDENCY_WIDTH = 4 * TILE_CHUNK_WIDTH;
+
+// Number of columns generated in the background past the right edge of the
+// display window
+const int DEFAULT_PREFETCH_WIDTH = 32;
+
+// Number of tiles a board needs before it is generated across threads
+const int PARALLEL_GENERATE_TILES = 1 << 16;
+
+// Number of edits that can be undone
+const int DEFAULT_UNDO_LIMIT = 100;
+
+// Once more than 1 / DAMAGE_ALL_FRACTION of the display window changed, the
+// whole window is redrawn instead of the cells one at a time
+const int DAMAGE_ALL_FRACTION = 4;
 
 // Direction to move in game
 enum GameDirection { DIR_UP, DIR_DOWN, DIR_LEFT, DIR_RIGHT };
@@ -37,7 +66,7 @@ public:
   * percentWall, and changes map
   * Effects: Creates a new gameboard - used primarly for testing purposes
   */
-  GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH, int s, double pWall = -1, map<int, map<int, shared_ptr<Block>>> c = {});
+  GameBoard(int nBlocksWide, int nBlocksHigh, int blockW, int blockH, int s, double pWall = -1, map<int, map<int, shared_ptr<Block>>> c = {}, int gVersion = GAME_VERSION);
 
   /**
   * Requires: nothing
@@ -51,10 +80,214 @@ public:
   // These getters are used for testing purposes
   int getSeed() const;
   double getPercentWall() const;
-  Player getPlayer() const;
+  int getGameVersion() const;
+  const Player &getPlayer() const;
   vector<vector<shared_ptr<Block>>> getBoard() const;
   map<int, map<int, shared_ptr<Block>>> getChanges() const;
 
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if the column is on the board
+  */
+  bool hasColumn(int column) const;
+
+  /**
+  * Requires: a column on the board and a row within it
+  * Modifies: nothing
+  * Effects: Returns the tile at the position, without copying the board
+  */
+  Tile getTile(int column, int row) const;
+
+  /**
+  * Requires: a column on the board
+  * Modifies: nothing
+  * Effects: Returns the numBlocksHigh tiles of the column, which stay valid
+  * until the board scrolls, is edited, or is generated again
+  */
+  const Tile *getColumn(int column) const;
+
+  /**
+  * Requires: a column on the board and a row within it
+  * Modifies: nothing
+  * Effects: Returns if the player (or a wall) can be moved on top of the
+  * position
+  */
+  bool isWalkable(int column, int row) const;
+
+  /**
+  * Requires: a column on the board
+  * Modifies: nothing
+  * Effects: Returns if any position in the column can be moved on top of
+  */
+  bool hasFreeCell(int column) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of walls on the board from firstColumn up to (but
+  * not including) lastColumn and firstRow up to (but not including) lastRow,
+  * or in the display window
+  */
+  int countWalls(int firstColumn, int lastColumn, int firstRow, int lastRow) const;
+  int countWallsInView() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns a view of the columns on the board from first up to (but
+  * not including) last, or of every column on the board
+  */
+  TileStore::ColumnRange getColumns(int first, int last) const;
+  TileStore::ColumnRange getColumns() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the changes to the generated tiles, which can be iterated
+  * over without copying them
+  *  Note: chunks of a binary save that haven't been on the board yet aren't
+  *  loaded, so their changes aren't included
+  */
+  const ChangeMap &getChangeMap() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of columns kept on each side of the display
+  * window, or the bytes used by the columns on the board
+  */
+  int getResidencyWidth() const;
+  size_t getBoardMemoryUsage() const;
+
+  /**
+  * Requires: a positive width, or 0 to keep every column
+  * Modifies: residencyWidth and board
+  * Effects: Sets the number of columns kept on each side of the display window
+  */
+  void setResidencyWidth(int width);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of columns generated in the background past the
+  * right edge of the display window
+  */
+  int getPrefetchWidth() const;
+
+  /**
+  * Requires: a positive width, or 0 to generate every column when it is needed
+  * Modifies: prefetchWidth and prefetcher
+  * Effects: Sets the number of columns generated in the background past the
+  * right edge of the display window
+  */
+  void setPrefetchWidth(int width);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of threads used to generate the board, or the
+  * seconds the last board took to generate
+  */
+  int getNumGenerateThreads() const;
+  double getGenerateSeconds() const;
+
+  /**
+  * Requires: a positive number of threads, or 0 to use every core
+  * Modifies: numGenerateThreads
+  * Effects: Sets the number of threads used to generate the board
+  */
+  void setNumGenerateThreads(int numThreads);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the edit journal of the save, or the number of records it
+  * can hold before it is compacted into the save
+  */
+  const EditJournal &getEditJournal() const;
+  int getJournalLimit() const;
+
+  /**
+  * Requires: a positive number of records, or 0 to always save the whole game
+  * Modifies: journalLimit
+  * Effects: Sets the number of records the edit journal can hold before it is
+  * compacted into the save
+  */
+  void setJournalLimit(int limit);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if saves drop the changes that match the generated tiles
+  */
+  bool getNormalizeSaves() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: normalizeSaves
+  * Effects: Sets if saves drop the changes that match the generated tiles
+  * (on the writer's thread for background saves)
+  */
+  void setNormalizeSaves(bool isNormalized);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if binary saves compress their chunks of changes
+  */
+  bool getCompressSaves() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: compressSaves
+  * Effects: Sets if binary saves compress their chunks of changes (which is
+  * kept in the save, and used again when it is loaded)
+  */
+  void setCompressSaves(bool isCompressed);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of edits that can be undone
+  */
+  int getUndoLimit() const;
+
+  /**
+  * Requires: a positive number of edits, or 0 to turn off undo
+  * Modifies: undoLimit and undoHistory
+  * Effects: Sets the number of edits that can be undone, forgetting the
+  * oldest ones past it
+  */
+  void setUndoLimit(int limit);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if there is an edit to undo or redo
+  */
+  bool canUndo() const;
+  bool canRedo() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: isGroupingEdits
+  * Effects: Starts (or ends) a group of edits that are undone as one, such as
+  * the edits made while dragging a wall
+  */
+  void beginEditGroup();
+  void endEditGroup();
+
+  /**
+  * Requires: nothing
+  * Modifies: board, changes, journal, undoHistory, and redoHistory
+  * Effects: Undoes the last edit (or group of edits), or redoes the last edit
+  * that was undone, returns if there was one that could be (an edit isn't
+  * undone or redone if it would put a wall on top of the player)
+  */
+  bool undo();
+  bool redo();
+
   /**
   * Requires: nothing
   * Modifies: nothing
@@ -76,14 +309,64 @@ public:
   /**
   * Requires: a valid path to save the file to
   * Modifies: nothing
-  * Effects: saves the game to a file, returns save status
+  * Effects: saves the game to a file (as JSON if it ends with
+  * JSON_SAVE_EXTENSION, otherwise in the binary layout), returns save status
   */
   bool saveGame(string filename = "");
 
   /**
-  * Requires: a valid path to an existing game file
+  * Requires: nothing
+  * Modifies: the save's edit journal (or the save)
+  * Effects: appends the cells changed since the last save to the save's edit
+  * journal, or saves the whole game if there isn't a save yet or the journal
+  * is full, returns save status
+  */
+  bool saveEdits();
+
+  /**
+  * Requires: nothing
+  * Modifies: saveWriter
+  * Effects: takes a snapshot of the game and saves it to the game's file on a
+  * background thread, joining a save that hasn't started yet
+  */
+  void saveGameAsync();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: returns if a background save is waiting or being written
+  */
+  bool isSaving() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: journal
+  * Effects: waits until every background save has finished, returns if the
+  * last one was written
+  */
+  bool waitForSaves();
+
+  /**
+  * Requires: nothing
+  * Modifies: journal
+  * Effects: drops the journal records that a finished background save has,
+  * and returns the time the last background save was written (or 0 if none
+  * has been)
+  */
+  long long finishSaves();
+
+  /**
+  * Requires: a valid path to save the file to
+  * Modifies: nothing
+  * Effects: saves the game to a file as JSON, returns save status
+  */
+  bool exportGame(string filename);
+
+  /**
+  * Requires: a valid path to an existing game file (binary or JSON)
   * Modifies: all GameBoard fields
-  * Effects: loads the game from a file, returns load status
+  * Effects: loads the game from a file and replays its edit journal, returns
+  * load status
   */
   bool loadGame(string filename = "");
 
@@ -134,11 +417,48 @@ public:
 
   /**
   * Requires: nothing
-  * Modifies: nothing
+  * Modifies: displayBatch and displayMesh
   * Effects: Displays the board to the screen
   */
   void display() const;
 
+  /**
+  * Requires: nothing
+  * Modifies: the backend and displayMesh
+  * Effects: Draws the board and player as one frame of the backend, the size
+  * of the game in pixels, filling one rectangle for each run of cells with
+  * the same color
+  */
+  void display(RenderBackend &backend) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if any cell in the display window changed since the board
+  * was last redrawn
+  */
+  bool hasDamage() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: damagedCells and isAllDamaged
+  * Effects: Marks the whole display window to be redrawn (like when what was
+  * drawn before is gone)
+  */
+  void damageAll();
+
+  /**
+  * Requires: the frame the board was last drawn into (or the screen)
+  * Modifies: the backend, displayBatch, damagedCells, isAllDamaged, and
+  * drawnDisplayEdge
+  * Effects: Draws just the cells that changed since the last redraw into the
+  * backend's grid (or every cell if they all did), scrolling it by the
+  * columns the display window moved so only the columns that came into view
+  * are drawn, and returns the number of cells drawn
+  */
+  int redraw();
+  int redraw(RenderBackend &backend);
+
 private:
   // Number of blocks to render for the height and for the width -- set at
   // object construction
@@ -151,32 +471,180 @@ private:
   // Left edge of the display window
   int leftDisplayEdge;
 
+  // Number of columns kept on each side of the display window, or 0 to keep
+  // every column
+  int residencyWidth;
+
+  // Number of columns generated in the background past the right edge of the
+  // display window, or 0 to generate every column when it is needed
+  int prefetchWidth;
+
+  // Number of threads used to generate the board, or 0 to use every core, and
+  // the seconds the last board took to generate
+  int numGenerateThreads;
+  double generateSeconds;
+
   // Store the seed used to generate the board
   int seed;
 
-  // Store the random object
-  mt19937 rand;
+  // Store the version of the save, which selects how the board is generated
+  int gameVersion;
+
+  // Store the generator for the seed, percent wall, and version
+  Generator generator;
 
-  // Generate a new distribution engine to consume the random object
-  uniform_real_distribution<> dist;
+  // Store the background generator for the columns right of the display
+  // window, if the generator is random access and prefetching is on
+  unique_ptr<ColumnPrefetcher> prefetcher;
 
   // Store the percent (in decimal) for the amount of random wall
   double percentWall;
 
-  // Store the 2D vector of pointers to the blocks on the board
-  // Stored as board[column][row]
-  vector<vector<shared_ptr<Block>>> board;
+  // Store the tiles on the board in column chunks
+  //  Note: only columns near the display window are on the board, the rest
+  //  are generated again from the seed and changes when they are needed
+  TileStore board;
+
+  // Store the changes to the generated tiles, keyed by column and row
+  //  Note: the change at (column, row) maps to the tile at board (column, row)
+  ChangeMap changes;
+
+  // Store the chunks of changes that are still only in the save that was
+  // loaded, keyed by chunk, and that save, which stays mapped while they are
+  // needed
+  map<int, SaveChunk> unloadedChunks;
+  shared_ptr<const MappedFile> saveFile;
+
+  // Store the cells changed since the save was last written, and the number
+  // of them it can hold before it is compacted into the save
+  EditJournal journal;
+  int journalLimit;
+
+  // Store the changes before each edit that can be undone (oldest first), the
+  // changes before each edit that was undone (newest last), and the number of
+  // edits that can be undone
+  //  Note: each copy of the changes shares the chunks it has in common with
+  //  the others, so only the chunks an edit changes are stored again
+  deque<ChangeMap> undoHistory;
+  vector<ChangeMap> redoHistory;
+  int undoLimit;
+
+  // Store if edits are being grouped to be undone as one, and if the changes
+  // before the group were stored yet
+  bool isGroupingEdits;
+  bool isGroupRemembered;
+
+  // Store if saves drop the changes that match the generated tiles, and if
+  // binary saves are compressed
+  bool normalizeSaves;
+  bool compressSaves;
 
-  // Store a map of changes to the default blocks
-  //  Note: changes[column][row] maps to the element at board[column][row]
-  map<int, map<int, shared_ptr<Block>>> changes;
+  // Store the background writer (started by the first background save), and
+  // the journal records and bytes that are in its newest save
+  unique_ptr<SaveWriter> saveWriter;
+  int journalSaveNumber;
+  int journalSaveRecords;
+  size_t journalSaveBytes;
 
   // Store the player object
   Player player;
 
+  // Store the rectangles of the last frame, so their memory is kept for the
+  // next one
+  mutable QuadBatch displayBatch;
+
+  // Store the rectangles the cells of each chunk are merged into, until one
+  // of them changes
+  mutable TileMesh displayMesh;
+
+  // Store the cells (on the board) that changed since the last redraw, if
+  // the whole display window has to be redrawn, and the left edge of the
+  // display window when it was last redrawn
+  vector<pair<int, int>> damagedCells;
+  bool isAllDamaged;
+  int drawnDisplayEdge;
+
   // Store the filename
   string gameFilename;
 
+  /**
+  * Requires: nothing
+  * Modifies: gameFilename and journal
+  * Effects: returns the game's filename, choosing one from the seed if it
+  * doesn't have one yet
+  */
+  string chooseGameFilename();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: returns everything that is stored in a save file
+  */
+  SaveData getSaveData() const;
+
+  /**
+  * Requires: everything stored in a save file
+  * Modifies: all GameBoard fields
+  * Effects: loads the game from the save data, returns load status
+  */
+  bool loadSaveData(SaveData &&data);
+
+  /**
+  * Requires: nothing
+  * Modifies: changes and journal
+  * Effects: applies the edit journal of the save to the changes
+  */
+  void replayJournal();
+
+  /**
+  * Requires: nothing
+  * Modifies: changes and unloadedChunks
+  * Effects: loads the chunks of changes from the save for the columns from
+  * firstColumn up to (but not including) lastColumn
+  */
+  void loadChunks(int firstColumn, int lastColumn);
+
+  /**
+  * Requires: nothing
+  * Modifies: undoHistory and redoHistory
+  * Effects: stores the changes before an edit so it can be undone, unless it
+  * is part of a group of edits whose changes are already stored
+  */
+  void rememberEdit();
+
+  /**
+  * Requires: a cell on the board
+  * Modifies: damagedCells and isAllDamaged
+  * Effects: marks the cell to be redrawn, or the whole display window once
+  * redrawing the cells one at a time would cost more than that
+  */
+  void damageCell(int column, int row);
+
+  /**
+  * Requires: a cell on the board, and its new tile
+  * Modifies: board, displayMesh, damagedCells, and isAllDamaged
+  * Effects: sets the tile of the cell, marking it to be redrawn and its chunk
+  * to be merged again
+  */
+  void setBoardTile(int column, int row, Tile tile);
+
+  /**
+  * Requires: a column in the display window, and a grid that shows it
+  * Modifies: the backend
+  * Effects: sets every cell of the column in the grid, and returns the number
+  * of cells set
+  */
+  int drawColumn(RenderBackend &backend, int column) const;
+
+  /**
+  * Requires: changes from before or after an edit
+  * Modifies: board, changes, and journal
+  * Effects: switches to the changes, updating the positions that differ on
+  * the board and in the journal, returns if it did (it doesn't if a wall
+  * would be put on top of the player)
+  */
+  bool restoreChanges(const ChangeMap &restored);
+
   /**
   * Requires: nothing
   * Modifies: board
@@ -185,11 +653,41 @@ private:
   void generateBoard();
 
   /**
-  * Requires: nothing
+  * Requires: a non-negative column
   * Modifies: board
-  * Effects: generates a new column for the board based on the seed
+  * Effects: generates the column of the board based on the seed, growing the
+  * board if needed
+  */
+  void generateColumn(int column);
+
+  /**
+  * Requires: a non-negative column, its tiles, and a random access generator
+  * (or the board's generator)
+  * Modifies: tiles and the column's walkability on the board
+  * Effects: fills in the tiles of the column from the generator and changes
+  */
+  void fillColumn(int column, Tile *tiles, Generator &columnGenerator);
+
+  /**
+  * Requires: a non-negative column and its tiles
+  * Modifies: tiles
+  * Effects: replaces the tiles of the column that have changes
+  */
+  void applyChanges(int column, Tile *tiles) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: prefetcher
+  * Effects: restarts the background generator past the right edge of the board
+  */
+  void startPrefetcher();
+
+  /**
+  * Requires: nothing
+  * Modifies: board and displayMesh
+  * Effects: drops the columns outside the residency width of the display window
   */
-  void generateColumn();
+  void removeDistantColumns();
 };
 
 #endif
@@ -1,4 +1,20 @@
 #include "gameboard_tests.hpp"
+#include <fstream>
+
+/**
+* Requires: two gameboards
+* Modifies: nothing
+* Effects: Returns if every column on the first board is on the second with
+* the same tiles (columns left of the display window are only on a board
+* once it has been there)
+*/
+static bool hasSameColumns(const GameBoard &g1, const GameBoard &g2) {
+  bool isSame = g1.getColumns().begin() != g1.getColumns().end();
+  for (TileStore::ColumnView view : g1.getColumns()) {
+    isSame = isSame && g2.hasColumn(view.column) && equal(view.tiles, view.tiles + g1.getNumBlocksHigh(), g2.getColumn(view.column));
+  }
+  return isSame;
+}
 
 bool gameboardTests_run() {
   cout << "Running Gameboard Tests:" << endl;
@@ -12,12 +28,21 @@ bool gameboardTests_run() {
   t.check(gameboardTests_getGamePixelWidthAndHeight());
   t.check(gameboardTests_convertCoordinates());
   t.check(gameboardTests_saveAndLoad());
+  t.check(gameboardTests_saveEdits());
+  t.check(gameboardTests_lazyChanges());
   t.check(gameboardTests_generateBoard());
+  t.check(gameboardTests_residency());
+  t.check(gameboardTests_prefetch());
+  t.check(gameboardTests_parallelGenerate());
+  t.check(gameboardTests_views());
+  t.check(gameboardTests_walkability());
   t.check(gameboardTests_movePlayer());
   t.check(gameboardTests_changeFloorTypeUnderPlayer());
   t.check(gameboardTests_moveWall());
   t.check(gameboardTests_addWall());
   t.check(gameboardTests_removeWall());
+  t.check(gameboardTests_undo());
+  t.check(gameboardTests_redraw());
 
   // Display pass or fail result
   if (t.getResult()) {
@@ -115,7 +140,7 @@ bool gameboardTests_saveAndLoad() {
   testChanges[3][6] = make_shared<Floor>();
 
   // Create an game with custom percentWall, seed, and changes, and save it
-  GameBoard g3(2, 3, 34, 35, 42, 0.3, testChanges);
+  GameBoard g3(2, 3, 34, 35, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   g3.movePlayer(DIR_RIGHT);
   g3.saveGame("testing.infinity.json");
   // Game map:
@@ -130,6 +155,139 @@ bool gameboardTests_saveAndLoad() {
   // Make sure the values were loaded correctly
   t.check(g3.getBlockHeight() == g4.getBlockHeight() && g3.getBlockWidth() == g4.getBlockWidth() && g3.getNumBlocksHigh() == g4.getNumBlocksHigh() && g3.getNumBlocksWide() == g4.getNumBlocksWide() && g3.getSeed() == g4.getSeed() && g3.getPercentWall() == g4.getPercentWall() && g4.getChanges()[1][1]->getBlockType() == WallBlock && g4.getChanges()[1][2]->getBlockType() == FloorBlock && g4.getChanges()[3][6]->getBlockType() == FloorBlock && g4.getPlayer().getVectorX() == 1 && g4.getPlayer().getVectorY() == 0, "saveGame() and loadGame() doesn't work for custom seed, percentWall, and changes");
 
+  // Make sure the game version was kept, so the board is generated the same way
+  t.check(g2.getGameVersion() == GAME_VERSION && g4.getGameVersion() == LEGACY_GAME_VERSION, "saveGame() and loadGame() doesn't keep the game version");
+
+  // Save the same game in the binary layout, and load it back
+  t.check(g3.saveGame("testing.infinity.bin") && isBinarySave("testing.infinity.bin"), "saveGame() didn't write a binary save");
+  GameBoard g5;
+  t.check(g5.loadGame("testing.infinity.bin"), "loadGame() couldn't load a binary save");
+  t.check(g5.getSeed() == 42 && g5.getGameVersion() == LEGACY_GAME_VERSION && g5.getNumBlocksWide() == 2 && g5.getBlockHeight() == 35 && g5.getPlayer().getVectorX() == 1, "Binary save didn't keep the game fields");
+  t.check(g5.getChangeMap() == g3.getChangeMap() && hasSameColumns(g5, g3), "Binary save didn't keep the board");
+
+  // Export the binary save as JSON, which should load the same game
+  GameBoard g6;
+  t.check(g5.exportGame("testing.infinity.json") && !isBinarySave("testing.infinity.json") && g6.loadGame("testing.infinity.json"), "exportGame() didn't write a JSON save");
+  t.check(g6.getChanges() == g3.getChanges() && hasSameColumns(g6, g3), "Exported JSON save didn't keep the board");
+
+  // Edits that put back the generated tile shouldn't be saved, unless saves
+  // aren't normalized
+  GameBoard g7(10, 10, 1, 1, 42, 0, {}, VECTOR_GAME_VERSION);
+  g7.addWall(5, 5);
+  g7.removeWall(5, 5);
+  SaveData saved;
+  t.check(g7.getChangeMap().hasChange(5, 5) && g7.saveGame("testing.infinity.bin") && readBinarySave("testing.infinity.bin", saved) && !saved.changes.hasChange(5, 5), "Edit that matches the generated tile was saved");
+  g7.setNormalizeSaves(false);
+  t.check(!g7.getNormalizeSaves() && g7.saveGame("testing.infinity.bin") && readBinarySave("testing.infinity.bin", saved) && saved.changes.hasChange(5, 5), "Edit was dropped without normalizing");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test saveEdits() and saveGameAsync() (and replaying the edit journal in
+// loadGame())
+bool gameboardTests_saveEdits() {
+  // Start new testing object
+  Testing t("saveEdits() and saveGameAsync()");
+
+  // Saving the whole game shouldn't leave anything in the journal
+  GameBoard g1(10, 10, 1, 1, 42, 0.3, {}, LEGACY_GAME_VERSION);
+  t.check(g1.addWall(5, 5) && g1.getEditJournal().getNumPending() == 1, "addWall() wasn't recorded");
+  t.check(g1.saveGame("testing.infinity.bin") && !ifstream("testing.infinity.bin" + EDIT_JOURNAL_EXTENSION), "saveGame() left a journal");
+
+  // Edits after loading a save should only go to its journal
+  GameBoard g2;
+  g2.loadGame("testing.infinity.bin");
+  g2.removeWall(5, 5);
+  g2.addWall(5, 6);
+  g2.moveWall(5, 6, 4, 5);
+  g2.changeFloorTypeUnderPlayer(SandFloor);
+  t.check(g2.getEditJournal().getNumRecords() == 5 && g2.getEditJournal().getNumPending() == 5, "Edits weren't recorded");
+  t.check(g2.saveEdits() && g2.getEditJournal().getNumPending() == 0 && g2.getEditJournal().getFilename() == "testing.infinity.bin" + EDIT_JOURNAL_EXTENSION, "saveEdits() didn't write the journal");
+
+  // Loading should replay the journal on top of the save
+  GameBoard g3;
+  t.check(g3.loadGame("testing.infinity.bin") && g3.getEditJournal().getNumRecords() == 5, "loadGame() didn't replay the journal");
+  t.check(g3.getChangeMap() == g2.getChangeMap() && g3.getBoard() == g2.getBoard(), "Replayed journal didn't give the same board");
+
+  // A full journal should be compacted into the save in the background, and
+  // removed once the save is written
+  g3.setJournalLimit(5);
+  g3.addWall(8, 8);
+  t.check(g3.saveEdits() && g3.getEditJournal().getNumRecords() == 6, "Full journal wasn't kept until it was compacted");
+  t.check(g3.waitForSaves() && g3.finishSaves() > 0 && g3.getEditJournal().getNumRecords() == 0 && !ifstream("testing.infinity.bin" + EDIT_JOURNAL_EXTENSION), "Full journal wasn't compacted");
+  GameBoard g4;
+  // (edits that match the generated tiles are dropped from the save)
+  t.check(g4.loadGame("testing.infinity.bin") && g4.getChangeMap().size() <= g3.getChangeMap().size() && g4.getBoard() == g3.getBoard(), "Compacted save didn't keep the edits");
+
+  // Edits made while a background save is written should stay in the journal
+  g4.saveGameAsync();
+  g4.removeWall(8, 8);
+  t.check(g4.saveEdits() && g4.waitForSaves() && g4.getEditJournal().getNumRecords() == 1, "Edits after a background save were dropped");
+  GameBoard g5;
+  t.check(g5.loadGame("testing.infinity.bin") && g5.getChangeMap() == g4.getChangeMap(), "Background save and journal didn't give the same changes");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test loading the chunks of changes of a binary save when they are needed
+bool gameboardTests_lazyChanges() {
+  // Start new testing object
+  Testing t("loading chunks of changes when they are needed");
+
+  // Write a save far to the right, with changes in a few chunks behind it
+  SaveData data;
+  data.gameVersion = VECTOR_GAME_VERSION;
+  data.saveTime = 0;
+  data.numBlocksWide = 10;
+  data.numBlocksHigh = 10;
+  data.blockWidth = 1;
+  data.blockHeight = 1;
+  data.leftDisplayEdge = 8 * SAVE_CHUNK_WIDTH;
+  data.seed = 42;
+  data.percentWall = 0;
+  data.player.setVectorX(8 * SAVE_CHUNK_WIDTH + 5);
+  data.player.setVectorY(5);
+  data.changes.setChange(3, 3, WALL_TILE);
+  data.changes.setChange(5 * SAVE_CHUNK_WIDTH + 7, 2, WALL_TILE);
+  data.changes.setChange(8 * SAVE_CHUNK_WIDTH + 1, 1, WALL_TILE);
+  t.check(writeBinarySave("testing.infinity.bin", data), "Couldn't write the save");
+
+  // Add a journal with an edit in the first chunk, which is newer than the save
+  EditJournal journal;
+  journal.setFilename("testing.infinity.bin" + EDIT_JOURNAL_EXTENSION);
+  journal.clear();
+  journal.record(3, 4, WALL_TILE);
+  journal.flush();
+
+  // Only the chunks near the display window (and the journal's) should be
+  // loaded
+  GameBoard g1;
+  t.check(g1.loadGame("testing.infinity.bin") && g1.getTile(8 * SAVE_CHUNK_WIDTH + 1, 1) == WALL_TILE, "Change near the display window wasn't loaded");
+  t.check(g1.getChangeMap().size() == 3 && g1.getChangeMap().hasChange(3, 3) && g1.getChangeMap().hasChange(3, 4) && !g1.getChangeMap().hasChange(5 * SAVE_CHUNK_WIDTH + 7, 2), "Wrong chunks were loaded");
+
+  // Saving should keep the chunk that was never loaded
+  SaveData saved;
+  t.check(g1.saveGame("testing.copy.infinity.bin") && readBinarySave("testing.copy.infinity.bin", saved) && saved.changes.size() == 4 && saved.changes.hasChange(5 * SAVE_CHUNK_WIDTH + 7, 2), "Unloaded chunk wasn't saved");
+  SaveSummary summary;
+  t.check(readSaveSummary("testing.copy.infinity.bin", summary) && summary.numChanges == 4, "Summary didn't count the unloaded chunk");
+
+  // Walking back to the chunk should load it
+  while (g1.getPlayer().getVectorX() > 5 * SAVE_CHUNK_WIDTH) {
+    g1.movePlayer(DIR_LEFT);
+  }
+  t.check(g1.getChangeMap().size() == 4 && g1.getTile(5 * SAVE_CHUNK_WIDTH + 7, 2) == WALL_TILE, "Chunk wasn't loaded when we walked back to it");
+
+  // Undoing an edit made before the chunk was loaded should keep the chunk
+  GameBoard g2;
+  t.check(g2.loadGame("testing.infinity.bin") && g2.addWall(0, 0), "Couldn't edit the loaded save");
+  while (g2.getPlayer().getVectorX() > 5 * SAVE_CHUNK_WIDTH) {
+    g2.movePlayer(DIR_LEFT);
+  }
+  t.check(g2.undo() && g2.getChangeMap() == g1.getChangeMap(), "Undo dropped a chunk loaded after the edit");
+
+  remove("testing.copy.infinity.bin");
+  remove(("testing.infinity.bin" + EDIT_JOURNAL_EXTENSION).c_str());
+
   return t.getResult(); // Return pass or fail result
 }
 
@@ -139,7 +297,7 @@ bool gameboardTests_generateBoard() {
   Testing t("generateBoard() (and generateColumn())");
 
   // Create an object with a custom seed
-  GameBoard g1(2, 3, 20, 20, 42, 0.3);
+  GameBoard g1(2, 3, 20, 20, 42, 0.3, {}, LEGACY_GAME_VERSION);
   // Game map:
   // F F
   // W F
@@ -154,7 +312,7 @@ bool gameboardTests_generateBoard() {
   testChanges[1][2] = make_shared<Floor>();
 
   // Create an object with a custom seed and changes
-  GameBoard g2(2, 3, 20, 20, 42, 0.3, testChanges);
+  GameBoard g2(2, 3, 20, 20, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   // Game map:
   // F F
   // W W
@@ -163,6 +321,256 @@ bool gameboardTests_generateBoard() {
   // Assert the board is correctly created from that random seed
   t.check(g2.getBoard()[0][0]->getBlockType() == FloorBlock && g2.getBoard()[0][1]->getBlockType() == WallBlock && g2.getBoard()[0][2]->getBlockType() == FloorBlock && g2.getBoard()[1][0]->getBlockType() == FloorBlock && g2.getBoard()[1][1]->getBlockType() == WallBlock && g2.getBoard()[1][2]->getBlockType() == FloorBlock, "generateBoard() with changes, random seed of 42, and percent wall of 0.3 doesn't work");
 
+  // Create two boards with the current generator and the same seed
+  GameBoard g3(5, 40, 20, 20, 42, 0.3);
+  GameBoard g4(5, 40, 20, 20, 42, 0.3);
+
+  // Walk one to the right so it generates new columns while scrolling
+  for (int i = 0; i < 10; i++) {
+    g4.movePlayer(DIR_RIGHT);
+  }
+
+  // Assert both boards agree on every column they have in common
+  bool matches = true;
+  for (int column = 0; column < g3.getBoard().size(); column++) {
+    for (int row = 0; row < g3.getNumBlocksHigh(); row++) {
+      if (!g4.getBoard()[column].empty() && g3.getBoard()[column][row]->getBlockType() != g4.getBoard()[column][row]->getBlockType()) {
+        matches = false;
+      }
+    }
+  }
+  t.check(matches, "generateBoard() with the current game version isn't deterministic");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test setResidencyWidth() (and dropping and regenerating columns)
+bool gameboardTests_residency() {
+  // Start new testing object
+  Testing t("setResidencyWidth() (and dropping and regenerating columns)");
+
+  // Clear a path along the top row, so the player can walk far to the right
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  for (int column = 0; column < 1000; column++) {
+    testChanges[column][0] = make_shared<Floor>();
+  }
+
+  // Create a reference board that keeps every column, and one that drops them
+  GameBoard g1(5, 20, 1, 1, 42, 0.3, testChanges);
+  g1.setResidencyWidth(0);
+  GameBoard g2(5, 20, 1, 1, 42, 0.3, testChanges);
+  g2.setResidencyWidth(TILE_CHUNK_WIDTH);
+  t.check(g2.getResidencyWidth() == TILE_CHUNK_WIDTH, "Residency width wasn't set");
+
+  // Edit a column that will be dropped
+  g2.movePlayer(DIR_RIGHT);
+  g2.changeFloorTypeUnderPlayer(SandFloor);
+  g2.addWall(2, 5);
+
+  // Walk both boards far to the right
+  size_t walkedMemory = 0;
+  for (int i = 0; i < 900; i++) {
+    g1.movePlayer(DIR_RIGHT);
+    g2.movePlayer(DIR_RIGHT);
+    if (i == 450) {
+      walkedMemory = g2.getBoardMemoryUsage();
+    }
+  }
+  t.check(g2.getPlayer().getVectorX() == 901, "Player couldn't walk along the cleared path");
+  t.check(g2.getBoardMemoryUsage() == walkedMemory && g2.getBoardMemoryUsage() < g1.getBoardMemoryUsage(), "Board memory keeps growing with the distance walked");
+  t.check(g2.getBoard()[1].empty(), "Column far to the left wasn't dropped");
+
+  // Walk back to the start
+  for (int i = 0; i < 901; i++) {
+    g2.movePlayer(DIR_LEFT);
+  }
+  t.check(g2.getPlayer().getVectorX() == 0, "Player couldn't walk back along the cleared path");
+
+  // The regenerated columns should match the reference board and keep the edits
+  vector<vector<shared_ptr<Block>>> board1 = g1.getBoard();
+  vector<vector<shared_ptr<Block>>> board2 = g2.getBoard();
+  bool matches = true;
+  for (int column = 3; column < 5; column++) {
+    for (int row = 0; row < 20; row++) {
+      matches = matches && board1[column][row]->getBlockType() == board2[column][row]->getBlockType();
+    }
+  }
+  t.check(matches, "Regenerated columns don't match the original columns");
+  t.check(dynamic_pointer_cast<Floor>(board2[1][0])->getFloorType() == SandFloor && board2[2][5]->getBlockType() == WallBlock, "Regenerated columns lost their changes");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test setPrefetchWidth() (and generating columns in the background)
+bool gameboardTests_prefetch() {
+  // Start new testing object
+  Testing t("setPrefetchWidth() (and generating columns in the background)");
+
+  // Clear a path along the top row, and add a wall far ahead of the window
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  for (int column = 0; column < 700; column++) {
+    testChanges[column][0] = make_shared<Floor>();
+  }
+  testChanges[300][5] = make_shared<Wall>();
+
+  // Create a tall board that generates every column when it is needed, and
+  // ones that generate them in the background
+  GameBoard g1(5, 300, 1, 1, 42, 0.3, testChanges);
+  g1.setPrefetchWidth(0);
+  g1.setResidencyWidth(0);
+  GameBoard g2(5, 300, 1, 1, 42, 0.3, testChanges);
+  g2.setResidencyWidth(0);
+  GameBoard g3(5, 300, 1, 1, 42, 0.3, testChanges);
+  g3.setPrefetchWidth(1);
+  g3.setResidencyWidth(0);
+  t.check(g1.getPrefetchWidth() == 0 && g2.getPrefetchWidth() == DEFAULT_PREFETCH_WIDTH && g3.getPrefetchWidth() == 1, "Prefetch width wasn't set");
+
+  // Walk all boards far to the right
+  for (int i = 0; i < 600; i++) {
+    g1.movePlayer(DIR_RIGHT);
+    g2.movePlayer(DIR_RIGHT);
+    g3.movePlayer(DIR_RIGHT);
+  }
+  t.check(g2.getPlayer().getVectorX() == 600 && g3.getPlayer().getVectorX() == 600, "Player couldn't walk along the cleared path");
+
+  // Every column should match the board without background generation
+  bool matches = true;
+  for (TileStore::ColumnView view : g1.getColumns()) {
+    matches = matches && g2.hasColumn(view.column) && g3.hasColumn(view.column);
+    matches = matches && equal(view.tiles, view.tiles + 300, g2.getColumn(view.column)) && equal(view.tiles, view.tiles + 300, g3.getColumn(view.column));
+  }
+  t.check(matches, "Columns generated in the background don't match");
+  t.check(g2.getTile(300, 5) == WALL_TILE, "Columns generated in the background lost their changes");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test generating the board across threads
+bool gameboardTests_parallelGenerate() {
+  // Start new testing object
+  Testing t("generateBoard() across threads");
+
+  // Add changes scattered over the board
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  for (int column = 0; column < 200; column += 7) {
+    testChanges[column][column * 3 % 1000] = make_shared<Floor>(SandFloor);
+    testChanges[column][999 - column] = make_shared<Wall>();
+  }
+
+  // Save large boards with large seeds, then load them on one thread and on
+  // several, which should match tile for tile
+  bool matches = true;
+  bool timed = true;
+  for (int seed : {2147483647, -2147483647, 1999999999}) {
+    for (int version : {COUNTER_GAME_VERSION, VECTOR_GAME_VERSION}) {
+      GameBoard g1(200, 1000, 1, 1, seed, 0.3, testChanges, version);
+      g1.saveGame("testing.infinity.json");
+      GameBoard g2;
+      g2.setNumGenerateThreads(1);
+      g2.loadGame("testing.infinity.json");
+      GameBoard g3;
+      g3.setNumGenerateThreads(4);
+      g3.loadGame("testing.infinity.json");
+      for (TileStore::ColumnView view : g1.getColumns()) {
+        matches = matches && g2.hasColumn(view.column) && g3.hasColumn(view.column);
+        matches = matches && equal(view.tiles, view.tiles + 1000, g2.getColumn(view.column)) && equal(view.tiles, view.tiles + 1000, g3.getColumn(view.column));
+      }
+      timed = timed && g2.getGenerateSeconds() > 0 && g3.getGenerateSeconds() > 0;
+    }
+  }
+  t.check(matches, "Board generated across threads doesn't match the board generated on one thread");
+  t.check(timed, "Time taken to generate the board wasn't reported");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test getTile(), getColumn(), getColumns(), and getChangeMap()
+bool gameboardTests_views() {
+  // Start new testing object
+  Testing t("getTile(), getColumn(), getColumns(), and getChangeMap()");
+
+  // Create an object with a custom seed and two changes
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  testChanges[1][2] = make_shared<Floor>(SandFloor);
+  testChanges[3][0] = make_shared<Wall>();
+  GameBoard g1(3, 3, 20, 20, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
+  vector<vector<shared_ptr<Block>>> board = g1.getBoard();
+
+  // The cell accessors should match the copied board
+  bool matches = true;
+  for (int column = 0; column < board.size(); column++) {
+    for (int row = 0; row < 3; row++) {
+      matches = matches && g1.getTile(column, row) == tileFromBlock(*board[column][row]) && g1.getColumn(column)[row] == g1.getTile(column, row);
+    }
+  }
+  t.check(matches, "Cell accessors don't match getBoard()");
+  t.check(g1.hasColumn(0) && !g1.hasColumn(-1) && !g1.hasColumn(board.size()), "hasColumn() doesn't match the board");
+
+  // The column ranges should visit the columns on the board in order
+  vector<int> columns;
+  for (TileStore::ColumnView view : g1.getColumns()) {
+    columns.push_back(view.column);
+    t.check(view.tiles == g1.getColumn(view.column), "Column view doesn't point into the board");
+  }
+  t.check(columns.size() == board.size() && columns.front() == 0 && columns.back() == board.size() - 1, "getColumns() didn't visit every column");
+  columns.clear();
+  for (TileStore::ColumnView view : g1.getColumns(1, 3)) {
+    columns.push_back(view.column);
+  }
+  t.check(columns == vector<int>({1, 2}), "getColumns() didn't visit the range of columns");
+  t.check(g1.getColumns(3, 1).begin() == g1.getColumns(3, 1).end(), "Empty range of columns isn't empty");
+
+  // The change map should hold the changes without copying them
+  const ChangeMap &changes = g1.getChangeMap();
+  int numChanges = 0;
+  for (const ChangeMap::Change &change : changes) {
+    numChanges++;
+    t.check(g1.getChanges()[change.getColumn()][change.getRow()] == sharedBlockFromTile(change.tile), "Change view doesn't match getChanges()");
+  }
+  t.check(numChanges == 2 && &changes == &g1.getChangeMap(), "getChangeMap() didn't return every change");
+  t.check(&g1.getPlayer() == &g1.getPlayer(), "getPlayer() copied the player");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test isWalkable(), hasFreeCell(), and countWalls()
+bool gameboardTests_walkability() {
+  // Start new testing object
+  Testing t("isWalkable(), hasFreeCell(), and countWalls()");
+
+  // Clear a path along the top row
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  for (int column = 0; column < 200; column++) {
+    testChanges[column][0] = make_shared<Floor>();
+  }
+
+  // Edit the board, then walk it to the right so columns come from the
+  // background generator
+  GameBoard g1(5, 100, 1, 1, 42, 0.3, testChanges);
+  g1.addWall(1, 1);
+  g1.removeWall(2, 2);
+  g1.moveWall(3, 3, 4, 4);
+  for (int i = 0; i < 150; i++) {
+    g1.movePlayer(DIR_RIGHT);
+  }
+  t.check(g1.getPlayer().getVectorX() == 150, "Player couldn't walk along the cleared path");
+
+  // The walkability should match every tile, and count the same walls
+  bool matches = true;
+  int numWalls = 0;
+  for (TileStore::ColumnView view : g1.getColumns()) {
+    bool hasFloor = false;
+    for (int row = 0; row < 100; row++) {
+      matches = matches && g1.isWalkable(view.column, row) == view.tiles[row].canMoveOnTop();
+      hasFloor = hasFloor || view.tiles[row].canMoveOnTop();
+      numWalls += !view.tiles[row].canMoveOnTop();
+    }
+    matches = matches && g1.hasFreeCell(view.column) == hasFloor;
+  }
+  t.check(matches, "Walkability doesn't match the board");
+  t.check(g1.countWalls(0, 1000, 0, 100) == numWalls, "countWalls() doesn't match the board");
+  t.check(g1.countWallsInView() == g1.countWalls(147, 152, 0, 100), "countWallsInView() doesn't count the display window");
+
   return t.getResult(); // Return pass or fail result
 }
 
@@ -176,7 +584,7 @@ bool gameboardTests_movePlayer() {
   testChanges[1][2] = make_shared<Floor>();
 
   // Create an object with a custom seed and one change
-  GameBoard g1(3, 3, 20, 20, 42, 0.3, testChanges);
+  GameBoard g1(3, 3, 20, 20, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   // Game map:
   // F F F | F F F
   // W F F | W W F
@@ -239,7 +647,7 @@ bool gameboardTests_changeFloorTypeUnderPlayer() {
   testChanges[1][2] = make_shared<Floor>();
 
   // Create an object with a custom seed and one change
-  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges);
+  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   // Game map:
   // F F F | F F F
   // W F F | W W F
@@ -275,6 +683,10 @@ bool gameboardTests_changeFloorTypeUnderPlayer() {
   g1.changeFloorTypeUnderPlayer(SandFloor);
   t.check(dynamic_pointer_cast<Floor>(g1.getBoard()[5][1])->getFloorType() == SandFloor, "Floor didn't change to sand in the newly generated region");
 
+  // Changing the floor shouldn't modify the shared grass floor used by the
+  // rest of the board
+  t.check(dynamic_pointer_cast<Floor>(g1.getBoard()[5][0])->getFloorType() == GrassFloor && g1.getChanges()[5][1] == g1.getChanges()[1][0], "Changing the floor type modified a shared block");
+
   return t.getResult(); // Return pass or fail result
 }
 
@@ -288,7 +700,7 @@ bool gameboardTests_moveWall() {
   testChanges[1][2] = make_shared<Floor>();
 
   // Create an object with a custom seed and one change
-  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges);
+  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   // Game map:
   // F F F | F F F
   // W F F | W W F
@@ -349,7 +761,7 @@ bool gameboardTests_addWall() {
   testChanges[1][2] = make_shared<Floor>();
 
   // Create an object with a custom seed and one change
-  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges);
+  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   // Game map:
   // F F F | F F F
   // W F F | W W F
@@ -373,6 +785,7 @@ bool gameboardTests_addWall() {
   t.check(g1.addWall(1, 1), "Something prevented a valid add");
   t.check(g1.getBoard()[1][1]->getBlockType() == WallBlock, "board at added position is not a wall");
   t.check(g1.getChanges()[1][1]->getBlockType() == WallBlock, "changes at added position is not a wall");
+  t.check(g1.getChanges()[1][1] == g1.getBoard()[0][1], "added wall doesn't share the generated wall's block");
 
   // Move player into newly generated region
   g1.movePlayer(DIR_RIGHT);
@@ -398,7 +811,7 @@ bool gameboardTests_removeWall() {
   testChanges[1][2] = make_shared<Floor>();
 
   // Create an object with a custom seed and one change
-  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges);
+  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
   // Game map:
   // F F F | F F F
   // W F F | W W F
@@ -433,3 +846,142 @@ bool gameboardTests_removeWall() {
 
   return t.getResult(); // Return pass or fail result
 }
+
+// Test undo() and redo()
+bool gameboardTests_undo() {
+  // Start new testing object
+  Testing t("undo() and redo()");
+
+  // Create a map of changes
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  testChanges[1][2] = make_shared<Floor>();
+
+  // Create an object with a custom seed and one change
+  GameBoard g1(3, 3, 1, 1, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
+  // Game map:
+  // F F F
+  // W F F
+  // F F W
+  vector<vector<shared_ptr<Block>>> initialBoard = g1.getBoard();
+  ChangeMap initialChanges = g1.getChangeMap();
+
+  // There shouldn't be anything to undo or redo yet
+  t.check(!g1.canUndo() && !g1.canRedo() && !g1.undo() && !g1.redo(), "Undid or redid without an edit");
+
+  // Add a wall, then drag it twice as one group of edits
+  t.check(g1.addWall(1, 1), "Couldn't add a wall");
+  vector<vector<shared_ptr<Block>>> addedBoard = g1.getBoard();
+  ChangeMap addedChanges = g1.getChangeMap();
+  g1.beginEditGroup();
+  t.check(g1.moveWall(1, 1, 2, 1) && g1.moveWall(2, 1, 2, 0), "Couldn't drag the wall");
+  g1.endEditGroup();
+  vector<vector<shared_ptr<Block>>> draggedBoard = g1.getBoard();
+  ChangeMap draggedChanges = g1.getChangeMap();
+
+  // Undoing should go back one group at a time, removing changes that weren't
+  // there before
+  t.check(g1.undo() && g1.getBoard() == addedBoard && g1.getChangeMap() == addedChanges, "Undo didn't undo the whole drag");
+  t.check(g1.undo() && g1.getBoard() == initialBoard && g1.getChangeMap() == initialChanges, "Undo didn't undo the added wall");
+  t.check(!g1.canUndo() && !g1.undo(), "Undid past the first edit");
+
+  // Redoing should go forward again
+  t.check(g1.redo() && g1.getBoard() == addedBoard && g1.getChangeMap() == addedChanges, "Redo didn't redo the added wall");
+  t.check(g1.redo() && g1.getBoard() == draggedBoard && g1.getChangeMap() == draggedChanges && !g1.canRedo(), "Redo didn't redo the drag");
+
+  // A new edit should drop the edits that can be redone
+  t.check(g1.undo() && g1.canRedo() && g1.removeWall(0, 1) && !g1.canRedo(), "New edit didn't drop the redo history");
+
+  // Undoing shouldn't put a wall back on top of the player
+  g1.movePlayer(DIR_DOWN);
+  t.check(g1.getPlayer().getVectorY() == 1 && !g1.undo() && g1.getBoard()[0][1]->getBlockType() == FloorBlock, "Undo put a wall on top of the player");
+  g1.movePlayer(DIR_UP);
+  t.check(g1.undo() && g1.getBoard()[0][1]->getBlockType() == WallBlock && g1.getChangeMap() == addedChanges, "Undo didn't put back the generated wall");
+
+  // Only the number of edits in the limit should be kept
+  g1.setUndoLimit(1);
+  t.check(g1.addWall(1, 0) && g1.addWall(2, 1) && g1.undo() && !g1.undo(), "Undo limit wasn't kept");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test hasDamage() and redraw()
+bool gameboardTests_redraw() {
+  // Start new testing object
+  Testing t("hasDamage() and redraw()");
+
+  // Create a map of changes
+  map<int, map<int, shared_ptr<Block>>> testChanges;
+  testChanges[1][2] = make_shared<Floor>();
+
+  // Create an object with a custom seed and one change
+  GameBoard g1(3, 3, 2, 2, 42, 0.3, testChanges, LEGACY_GAME_VERSION);
+  // Game map:
+  // F F F
+  // W F F
+  // F F W
+
+  // Returns if the frame matches the whole board drawn from scratch
+  auto isCurrent = [](const GameBoard &g, const FrameBuffer &frame) {
+    FrameBuffer full;
+    g.display(full);
+    return frame.getPixels() == full.getPixels();
+  };
+
+  // The first redraw draws every cell, and then there is nothing to draw
+  FrameBuffer frame;
+  t.check(g1.hasDamage() && g1.redraw(frame) == 9 && isCurrent(g1, frame) && !g1.hasDamage(), "First redraw didn't draw the whole board");
+  t.check(g1.redraw(frame) == 0 && isCurrent(g1, frame), "Redraw drew without any changes");
+
+  // Edits that fail shouldn't damage anything
+  t.check(!g1.moveWall(2, 2, 4, 2) && !g1.addWall(0, 0) && !g1.removeWall(2, 2) && !g1.hasDamage(), "Failed edits damaged the board");
+  g1.movePlayer(DIR_UP);
+  t.check(!g1.hasDamage(), "Blocked move damaged the board");
+
+  // Moving the player redraws the cell it left and the one it entered
+  g1.movePlayer(DIR_RIGHT);
+  t.check(g1.hasDamage() && g1.redraw(frame) == 2 && frame.getNumRects() == 3 && isCurrent(g1, frame), "Moving the player didn't redraw its two cells");
+
+  // Edits redraw just the cells they changed
+  t.check(g1.addWall(0, 0) && g1.redraw(frame) == 1 && isCurrent(g1, frame), "Adding a wall didn't redraw its cell");
+  t.check(g1.moveWall(0, 0, 0, 5) && g1.redraw(frame) == 2 && isCurrent(g1, frame), "Moving a wall didn't redraw its two cells");
+  g1.changeFloorTypeUnderPlayer(SandFloor);
+  g1.swapPlayerColor();
+  t.check(g1.redraw(frame) == 1 && isCurrent(g1, frame), "Changing the player's cell didn't redraw it");
+  t.check(g1.undo() && g1.hasDamage() && g1.redraw(frame) == 1 && isCurrent(g1, frame), "Undo didn't redraw the cell it changed");
+
+  // Changing most of the window redraws all of it
+  t.check(g1.removeWall(0, 2) && g1.removeWall(4, 4) && g1.addWall(0, 0) && g1.redraw(frame) == 9 && isCurrent(g1, frame), "Changing most cells didn't redraw the whole board");
+
+  // Scrolling only draws the column that came into view, besides the cells
+  // the player left and entered (the player scrolls the window when moving
+  // next to its edge)
+  GameBoard g2(16, 3, 2, 1, 42, 0, {}, LEGACY_GAME_VERSION);
+  FrameBuffer frame2;
+  g2.redraw(frame2);
+  g2.movePlayer(DIR_RIGHT);
+  g2.movePlayer(DIR_RIGHT);
+  t.check(g2.redraw(frame2) == 3 && isCurrent(g2, frame2), "Moving without scrolling didn't redraw just the player's cells");
+  int numDrawn = 0;
+  while (g2.getPlayer().getVectorX() < 13) {
+    g2.movePlayer(DIR_RIGHT);
+    numDrawn = g2.redraw(frame2);
+  }
+  t.check(numDrawn == 3 + 2 && isCurrent(g2, frame2), "Scrolling right didn't redraw just the new column");
+
+  // Scrolling back and forth keeps the ring of columns current, including a
+  // scroll by more than one column between redraws
+  bool isSame = true;
+  for (int i = 0; i < 40; i++) {
+    g2.movePlayer(i % 20 < 10 ? DIR_RIGHT : DIR_LEFT);
+    g2.movePlayer(i % 2 == 0 ? DIR_DOWN : DIR_UP);
+    if (i % 3 != 0) {
+      g2.redraw(frame2);
+      isSame = isSame && isCurrent(g2, frame2);
+    }
+  }
+  t.check(isSame, "Scrolling back and forth didn't keep the frame current");
+  g2.damageAll();
+  t.check(g2.redraw(frame2) == 16 * 3 && isCurrent(g2, frame2), "damageAll() didn't redraw the whole board");
+
+  return t.getResult(); // Return pass or fail result
+}
@@ -1,6 +1,7 @@
 #ifndef gameboard_tests_hpp
 #define gameboard_tests_hpp
 
+#include "framebuffer.hpp"
 #include "gameboard.hpp"
 #include "testing.hpp"
 
@@ -40,6 +41,22 @@ bool gameboardTests_convertCoordinates();
 */
 bool gameboardTests_saveAndLoad();
 
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test saveEdits() and saveGameAsync() (and replaying the edit
+* journal in loadGame())
+*/
+bool gameboardTests_saveEdits();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test loading the chunks of changes of a binary save when they are
+* needed
+*/
+bool gameboardTests_lazyChanges();
+
 /**
 * Requires: nothing
 * Modifies: nothing
@@ -47,6 +64,41 @@ bool gameboardTests_saveAndLoad();
 */
 bool gameboardTests_generateBoard();
 
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test setResidencyWidth() (and dropping and regenerating columns)
+*/
+bool gameboardTests_residency();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test setPrefetchWidth() (and generating columns in the background)
+*/
+bool gameboardTests_prefetch();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test generating the board across threads
+*/
+bool gameboardTests_parallelGenerate();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test getTile(), getColumn(), getColumns(), and getChangeMap()
+*/
+bool gameboardTests_views();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test isWalkable(), hasFreeCell(), and countWalls()
+*/
+bool gameboardTests_walkability();
+
 /**
 * Requires: nothing
 * Modifies: nothing
@@ -82,4 +134,18 @@ bool gameboardTests_addWall();
 */
 bool gameboardTests_removeWall();
 
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test undo() and redo()
+*/
+bool gameboardTests_undo();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Test hasDamage() and redraw()
+*/
+bool gameboardTests_redraw();
+
 #endif
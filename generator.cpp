@@ -0,0 +1,382 @@
+#include "generator.hpp"
+#include <sstream>
+
+// Vector kernels are only built for x86 with GCC style target attributes
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GENERATOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/**
+* Requires: a 64 bit value
+* Modifies: nothing
+* Effects: Returns the splitmix64 finalizer of the value
+*/
+static uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+* Requires: a 32 bit value
+* Modifies: nothing
+* Effects: Returns the lowbias32 mix of the value
+*/
+static inline uint32_t mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352DU;
+  x ^= x >> 15;
+  x *= 0x846CA68BU;
+  return x ^ (x >> 16);
+}
+
+/**
+* Requires: the column's hash, the largest hash that is a wall, and rows
+* between first and numRows
+* Modifies: wallBits
+* Effects: Sets the bit of every wall from first up to numRows, one row at a time
+*/
+static void scalarKernel(uint32_t columnHash, uint32_t wallLimit, int first, int numRows, uint64_t *wallBits) {
+  for (int row = first; row < numRows; row++) {
+    if (mix32(static_cast<uint32_t>(row) * 0x9E3779B9U ^ columnHash) <= wallLimit) {
+      wallBits[row / 64] |= 1ULL << (row % 64);
+    }
+  }
+}
+
+#ifdef GENERATOR_X86_KERNELS
+/**
+* Requires: the column's hash, the largest hash that is a wall, and a number
+* of rows
+* Modifies: wallBits
+* Effects: Sets the bit of every wall 8 rows at a time with AVX2, and returns
+* the number of rows done
+*/
+__attribute__((target("avx2"))) static int avx2Kernel(uint32_t columnHash, uint32_t wallLimit, int numRows, uint64_t *wallBits) {
+  // Flip the sign bits so the signed compare orders hashes as unsigned
+  const __m256i sign = _mm256_set1_epi32(0x80000000);
+  const __m256i limit = _mm256_xor_si256(_mm256_set1_epi32(wallLimit), sign);
+  const __m256i hash = _mm256_set1_epi32(columnHash);
+  const __m256i golden = _mm256_set1_epi32(0x9E3779B9);
+  __m256i rows = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  int row = 0;
+  for (; row + 8 <= numRows; row += 8) {
+    // Mix each row's key the same way as mix32()
+    __m256i x = _mm256_xor_si256(_mm256_mullo_epi32(rows, golden), hash);
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7FEB352D));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x846CA68B));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+
+    // Rows above the limit are floors, the rest are walls
+    __m256i floors = _mm256_cmpgt_epi32(_mm256_xor_si256(x, sign), limit);
+    uint64_t walls = ~_mm256_movemask_ps(_mm256_castsi256_ps(floors)) & 0xFF;
+    wallBits[row / 64] |= walls << (row % 64);
+
+    rows = _mm256_add_epi32(rows, _mm256_set1_epi32(8));
+  }
+  return row;
+}
+
+/**
+* Requires: the column's hash, the largest hash that is a wall, and a number
+* of rows
+* Modifies: wallBits
+* Effects: Sets the bit of every wall 4 rows at a time with SSE4.1, and
+* returns the number of rows done
+*/
+__attribute__((target("sse4.1"))) static int sse41Kernel(uint32_t columnHash, uint32_t wallLimit, int numRows, uint64_t *wallBits) {
+  // Flip the sign bits so the signed compare orders hashes as unsigned
+  const __m128i sign = _mm_set1_epi32(0x80000000);
+  const __m128i limit = _mm_xor_si128(_mm_set1_epi32(wallLimit), sign);
+  const __m128i hash = _mm_set1_epi32(columnHash);
+  const __m128i golden = _mm_set1_epi32(0x9E3779B9);
+  __m128i rows = _mm_setr_epi32(0, 1, 2, 3);
+
+  int row = 0;
+  for (; row + 4 <= numRows; row += 4) {
+    // Mix each row's key the same way as mix32()
+    __m128i x = _mm_xor_si128(_mm_mullo_epi32(rows, golden), hash);
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+    x = _mm_mullo_epi32(x, _mm_set1_epi32(0x7FEB352D));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+    x = _mm_mullo_epi32(x, _mm_set1_epi32(0x846CA68B));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+
+    // Rows above the limit are floors, the rest are walls
+    __m128i floors = _mm_cmpgt_epi32(_mm_xor_si128(x, sign), limit);
+    uint64_t walls = ~_mm_movemask_ps(_mm_castsi128_ps(floors)) & 0xF;
+    wallBits[row / 64] |= walls << (row % 64);
+
+    rows = _mm_add_epi32(rows, _mm_set1_epi32(4));
+  }
+  return row;
+}
+#endif
+
+/**
+* Requires: nothing
+* Modifies: seed, percentWall, and version
+* Effects: Creates a new generator
+*/
+Generator::Generator() : Generator(0, 0.3, VECTOR_GAME_VERSION) {
+}
+/**
+* Requires: a seed, a percent wall between 0 and 1, and a known version
+* Modifies: seed, percentWall, and version
+* Effects: Creates a new generator for the save version
+*/
+Generator::Generator(int s, double pWall, int v) {
+  seed = s;
+  percentWall = pWall;
+  version = v;
+
+  // Hash the seed once, since every counter-based value uses it
+  seedHash = mix64(static_cast<uint32_t>(seed) + 0x9E3779B97F4A7C15ULL);
+
+  // Scale the percent wall to the range of a 32 bit hash
+  if (percentWall <= 0) {
+    wallThreshold = 0;
+  } else if (percentWall >= 1) {
+    wallThreshold = 1ULL << 32;
+  } else {
+    wallThreshold = static_cast<uint64_t>(percentWall * 4294967296.0);
+  }
+  vectorized = true;
+
+  // Start the legacy stream at the first column
+  rand.seed(seed);
+  nextColumn = 0;
+  streamRows = 0;
+  checkpointRows = 0;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the respective field
+*/
+int Generator::getSeed() const {
+  return seed;
+}
+double Generator::getPercentWall() const {
+  return percentWall;
+}
+int Generator::getVersion() const {
+  return version;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if columns can be generated in any order without replaying
+* the columns before them
+*/
+bool Generator::isRandomAccess() const {
+  return version != LEGACY_GAME_VERSION;
+}
+
+/**
+* Requires: nothing
+* Modifies: vectorized
+* Effects: Sets if version 3 columns use the vector kernel when the CPU
+* supports it (the scalar kernel gives the same bits)
+*/
+void Generator::setVectorized(bool v) {
+  vectorized = v;
+}
+
+/**
+* Requires: a non-negative column and a positive number of rows
+* Modifies: wallBits (and the random stream for legacy versions)
+* Effects: Generates the column, setting bit (row % 64) of wallBits[row / 64]
+* for every row that is a wall
+*/
+void Generator::generateColumn(int column, int numRows, vector<uint64_t> &wallBits) {
+  // Clear the bits for the column
+  wallBits.assign((numRows + 63) / 64, 0);
+
+  if (version == VECTOR_GAME_VERSION) {
+    // Nothing is a wall below the smallest threshold
+    if (wallThreshold == 0) {
+      return;
+    }
+
+    // Hash the column once, then each row only needs a 32 bit mix
+    uint32_t columnHash = static_cast<uint32_t>(mix64(seedHash ^ static_cast<uint32_t>(column)));
+    uint32_t wallLimit = static_cast<uint32_t>(wallThreshold - 1);
+
+    // Use the widest kernel the CPU has, and finish the leftover rows with the
+    // scalar kernel
+    int row = 0;
+#ifdef GENERATOR_X86_KERNELS
+    if (vectorized && __builtin_cpu_supports("avx2")) {
+      row = avx2Kernel(columnHash, wallLimit, numRows, wallBits.data());
+    } else if (vectorized && __builtin_cpu_supports("sse4.1")) {
+      row = sse41Kernel(columnHash, wallLimit, numRows, wallBits.data());
+    }
+#endif
+    scalarKernel(columnHash, wallLimit, row, numRows, wallBits.data());
+  } else if (isRandomAccess()) {
+    // Each cell only depends on the seed and its position
+    for (int row = 0; row < numRows; row++) {
+      if (counterValue(column, row) <= percentWall) {
+        wallBits[row / 64] |= 1ULL << (row % 64);
+      }
+    }
+  } else {
+    // The legacy stream must be at the start of the column, so move it there
+    // if we are jumping around or the height changed
+    if (column != nextColumn || numRows != streamRows) {
+      seekStream(column, numRows);
+    }
+    checkpointStream(column, numRows);
+
+    // Draw one value per row, in order
+    for (int row = 0; row < numRows; row++) {
+      if (dist(rand) <= percentWall) {
+        wallBits[row / 64] |= 1ULL << (row % 64);
+      }
+    }
+
+    // Remember where the stream is
+    nextColumn = column + 1;
+    streamRows = numRows;
+  }
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the checkpoints of the version 1 stream, sorted by column,
+* or the number of rows they were taken with
+*/
+vector<StreamCheckpoint> Generator::getCheckpoints() const {
+  vector<StreamCheckpoint> sorted;
+  for (const pair<const int, vector<uint32_t>> &checkpoint : checkpoints) {
+    sorted.push_back({checkpoint.first, checkpoint.second});
+  }
+  return sorted;
+}
+int Generator::getCheckpointRows() const {
+  return checkpointRows;
+}
+
+/**
+* Requires: checkpoints taken by a generator with the same seed, and the
+* number of rows they were taken with
+* Modifies: checkpoints and checkpointRows
+* Effects: Adds the checkpoints, so version 1 columns can be generated from
+* the closest one instead of from the seed
+*/
+void Generator::setCheckpoints(const vector<StreamCheckpoint> &c, int numRows) {
+  // Checkpoints for another height are at different points in the stream
+  if (numRows != checkpointRows) {
+    checkpoints.clear();
+    checkpointRows = numRows;
+  }
+  for (const StreamCheckpoint &checkpoint : c) {
+    if (checkpoint.column > 0 && checkpoint.column % STREAM_CHECKPOINT_INTERVAL == 0) {
+      checkpoints[checkpoint.column] = checkpoint.state;
+    }
+  }
+}
+
+/**
+* Requires: a non-negative column and a positive number of rows
+* Modifies: the random stream and checkpoints
+* Effects: Moves the legacy stream to the start of the column, from wherever
+* is closest before it (the stream, a checkpoint, or the seed)
+*/
+void Generator::seekStream(int column, int numRows) {
+  // Checkpoints for another height are at different points in the stream
+  if (numRows != checkpointRows) {
+    checkpoints.clear();
+    checkpointRows = numRows;
+  }
+
+  // Keep going from the stream if it is before the column
+  int start = 0;
+  bool isStreamBefore = numRows == streamRows && nextColumn <= column;
+  if (isStreamBefore) {
+    start = nextColumn;
+  }
+
+  // Otherwise start from the closest checkpoint past it, or the seed
+  map<int, vector<uint32_t>>::iterator checkpoint = checkpoints.upper_bound(column);
+  while (checkpoint != checkpoints.begin() && (--checkpoint)->first > start) {
+    if (restoreStream(checkpoint->second)) {
+      start = checkpoint->first;
+      isStreamBefore = true;
+      break;
+    }
+    // Drop checkpoints this library can't read
+    checkpoint = checkpoints.erase(checkpoint);
+  }
+  if (!isStreamBefore) {
+    rand.seed(seed);
+  }
+
+  // Replay the columns in between, keeping checkpoints along the way
+  for (int skipped = start; skipped < column; skipped++) {
+    checkpointStream(skipped, numRows);
+    for (int row = 0; row < numRows; row++) {
+      dist(rand);
+    }
+  }
+}
+
+/**
+* Requires: the stream to be at the start of the column
+* Modifies: checkpoints
+* Effects: Stores the stream if the column is a checkpoint
+*/
+void Generator::checkpointStream(int column, int numRows) {
+  if (column == 0 || column % STREAM_CHECKPOINT_INTERVAL != 0 || numRows != checkpointRows || checkpoints.count(column) > 0) {
+    return;
+  }
+
+  // Keep the numbers the stream writes
+  stringstream text;
+  text << rand;
+  vector<uint32_t> &state = checkpoints[column];
+  uint32_t word;
+  while (text >> word) {
+    state.push_back(word);
+  }
+}
+
+/**
+* Requires: a checkpoint's state
+* Modifies: the random stream
+* Effects: Moves the stream to the checkpoint, returns if it could
+*/
+bool Generator::restoreStream(const vector<uint32_t> &state) {
+  stringstream text;
+  for (uint32_t word : state) {
+    text << word << ' ';
+  }
+  mt19937 restored;
+  if (!(text >> restored)) {
+    return false;
+  }
+  rand = restored;
+  return true;
+}
+
+/**
+* Requires: a non-negative column and row
+* Modifies: nothing
+* Effects: Returns the counter-based value in [0, 1) for the cell
+*/
+double Generator::counterValue(int column, int row) const {
+  // Pack the position into one key and hash it with the seed
+  uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) | static_cast<uint32_t>(row);
+  uint64_t hash = mix64(seedHash ^ mix64(key));
+
+  // Use the top 53 bits as the mantissa of a double
+  return (hash >> 11) * (1.0 / 9007199254740992.0);
+}
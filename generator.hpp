@@ -0,0 +1,155 @@
+#ifndef generator_hpp
+#define generator_hpp
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Save versions understood by the generator
+//  Version 1 draws every cell from a single mt19937 stream, so columns must be
+//  generated in order. Version 2 hashes (seed, column, row), so any column can
+//  be generated on its own. Version 3 hashes (seed, column, row) down to 32
+//  bits and compares it with an integer threshold, so a whole column can be
+//  generated with vector instructions.
+const int LEGACY_GAME_VERSION = 1;
+const int COUNTER_GAME_VERSION = 2;
+const int VECTOR_GAME_VERSION = 3;
+
+// Number of columns between the checkpoints of the version 1 stream
+const int STREAM_CHECKPOINT_INTERVAL = 1024;
+
+// State of the version 1 stream at the start of a column, as the numbers the
+// stream writes with operator<<
+struct StreamCheckpoint {
+  int column;
+  vector<uint32_t> state;
+};
+
+class Generator {
+public:
+  /**
+  * Requires: nothing
+  * Modifies: seed, percentWall, and version
+  * Effects: Creates a new generator
+  */
+  Generator();
+  /**
+  * Requires: a seed, a percent wall between 0 and 1, and a known version
+  * Modifies: seed, percentWall, and version
+  * Effects: Creates a new generator for the save version
+  */
+  Generator(int s, double pWall, int v);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the respective field
+  */
+  int getSeed() const;
+  double getPercentWall() const;
+  int getVersion() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if columns can be generated in any order without replaying
+  * the columns before them
+  */
+  bool isRandomAccess() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: vectorized
+  * Effects: Sets if version 3 columns use the vector kernel when the CPU
+  * supports it (the scalar kernel gives the same bits)
+  */
+  void setVectorized(bool v);
+
+  /**
+  * Requires: a non-negative column and a positive number of rows
+  * Modifies: wallBits (and the random stream for legacy versions)
+  * Effects: Generates the column, setting bit (row % 64) of wallBits[row / 64]
+  * for every row that is a wall
+  */
+  void generateColumn(int column, int numRows, vector<uint64_t> &wallBits);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the checkpoints of the version 1 stream, sorted by column,
+  * or the number of rows they were taken with
+  */
+  vector<StreamCheckpoint> getCheckpoints() const;
+  int getCheckpointRows() const;
+
+  /**
+  * Requires: checkpoints taken by a generator with the same seed, and the
+  * number of rows they were taken with
+  * Modifies: checkpoints and checkpointRows
+  * Effects: Adds the checkpoints, so version 1 columns can be generated from
+  * the closest one instead of from the seed
+  */
+  void setCheckpoints(const vector<StreamCheckpoint> &c, int numRows);
+
+private:
+  // Store the seed, percent wall, and save version
+  int seed;
+  double percentWall;
+  int version;
+
+  // Hash of the seed, mixed into every counter-based value
+  uint64_t seedHash;
+
+  // Version 3 cells are walls if their 32 bit hash is below the threshold,
+  // which is at most 2^32
+  uint64_t wallThreshold;
+  bool vectorized;
+
+  // Legacy stream state
+  mt19937 rand;
+  uniform_real_distribution<> dist;
+
+  // Next column the legacy stream will produce and the column height it was
+  // produced with
+  int nextColumn;
+  int streamRows;
+
+  // Store the legacy stream at the start of every STREAM_CHECKPOINT_INTERVAL
+  // columns it has passed, for columns checkpointRows high
+  map<int, vector<uint32_t>> checkpoints;
+  int checkpointRows;
+
+  /**
+  * Requires: a non-negative column and a positive number of rows
+  * Modifies: the random stream and checkpoints
+  * Effects: Moves the legacy stream to the start of the column, from wherever
+  * is closest before it (the stream, a checkpoint, or the seed)
+  */
+  void seekStream(int column, int numRows);
+
+  /**
+  * Requires: the stream to be at the start of the column
+  * Modifies: checkpoints
+  * Effects: Stores the stream if the column is a checkpoint
+  */
+  void checkpointStream(int column, int numRows);
+
+  /**
+  * Requires: a checkpoint's state
+  * Modifies: the random stream
+  * Effects: Moves the stream to the checkpoint, returns if it could
+  */
+  bool restoreStream(const vector<uint32_t> &state);
+
+  /**
+  * Requires: a non-negative column and row
+  * Modifies: nothing
+  * Effects: Returns the counter-based value in [0, 1) for the cell
+  */
+  double counterValue(int column, int row) const;
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "generator_tests.hpp"
+
+bool generatorTests_run() {
+  cout << "Running Generator Tests:" << endl;
+  cout << "------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(generatorTests_legacy());
+  t.check(generatorTests_counter());
+  t.check(generatorTests_vector());
+  t.check(generatorTests_checkpoints());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test the legacy mt19937 stream generator
+bool generatorTests_legacy() {
+  // Start new testing object
+  Testing t("generateColumn() for the legacy version");
+
+  // Draw the first two columns straight from the stream, the same way the
+  // first version of the game did
+  mt19937 rand(42);
+  uniform_real_distribution<> dist;
+  vector<bool> expected;
+  for (int i = 0; i < 2 * 7; i++) {
+    expected.push_back(dist(rand) <= 0.3);
+  }
+
+  // Generate the columns in order and make sure they match the stream
+  Generator g1(42, 0.3, LEGACY_GAME_VERSION);
+  vector<uint64_t> bits;
+  bool matches = true;
+  for (int column = 0; column < 2; column++) {
+    g1.generateColumn(column, 7, bits);
+    for (int row = 0; row < 7; row++) {
+      matches = matches && ((bits[0] >> row) & 1) == expected[column * 7 + row];
+    }
+  }
+  t.check(matches, "Legacy columns don't match the mt19937 stream");
+  t.check(!g1.isRandomAccess(), "Legacy generator claims random access");
+
+  // Jump straight to the second column, which must replay the first
+  Generator g2(42, 0.3, LEGACY_GAME_VERSION);
+  g2.generateColumn(1, 7, bits);
+  matches = true;
+  for (int row = 0; row < 7; row++) {
+    matches = matches && ((bits[0] >> row) & 1) == expected[7 + row];
+  }
+  t.check(matches, "Legacy generator doesn't replay the stream when jumping to a column");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test the counter-based random access generator
+bool generatorTests_counter() {
+  // Start new testing object
+  Testing t("generateColumn() for the counter-based version");
+
+  // Generate columns in order with one generator
+  Generator g1(42, 0.3, COUNTER_GAME_VERSION);
+  vector<vector<uint64_t>> inOrder(50);
+  for (int column = 0; column < 50; column++) {
+    g1.generateColumn(column, 100, inOrder[column]);
+  }
+  t.check(g1.isRandomAccess(), "Counter-based generator doesn't claim random access");
+  t.check(inOrder[0].size() == 2, "Column bits aren't sized to the number of rows");
+
+  // Generate them backwards with another, and make sure they match
+  Generator g2(42, 0.3, COUNTER_GAME_VERSION);
+  vector<uint64_t> bits;
+  bool matches = true;
+  for (int column = 49; column >= 0; column--) {
+    g2.generateColumn(column, 100, bits);
+    matches = matches && bits == inOrder[column];
+  }
+  t.check(matches, "Counter-based columns depend on the order they are generated in");
+
+  // Count the walls, which should be close to the percent wall
+  int numWalls = 0;
+  for (int column = 0; column < 50; column++) {
+    for (int row = 0; row < 100; row++) {
+      numWalls += (inOrder[column][row / 64] >> (row % 64)) & 1;
+    }
+  }
+  t.check(numWalls > 1300 && numWalls < 1700, "Counter-based generator doesn't follow the percent wall");
+
+  // A different seed should give a different column
+  Generator g3(43, 0.3, COUNTER_GAME_VERSION);
+  g3.generateColumn(0, 100, bits);
+  t.check(bits != inOrder[0], "Different seeds generate the same column");
+
+  // A far away column should be generated without walking to it
+  g3.generateColumn(1000000000, 100, bits);
+  t.check(bits.size() == 2, "Couldn't generate a far away column");
+
+  // Percent walls of 0 and 1 should give all floors and all walls
+  Generator g4(42, 0, COUNTER_GAME_VERSION);
+  g4.generateColumn(7, 64, bits);
+  t.check(bits[0] == 0, "Percent wall of 0 generated a wall");
+  Generator g5(42, 1, COUNTER_GAME_VERSION);
+  g5.generateColumn(7, 64, bits);
+  t.check(bits[0] == ~0ULL, "Percent wall of 1 generated a floor");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test the vectorized generator against its scalar kernel
+bool generatorTests_vector() {
+  // Start new testing object
+  Testing t("generateColumn() for the vectorized version");
+
+  // Generate tall and odd sized columns with both kernels, which should match
+  // bit for bit
+  Generator g1(42, 0.3, VECTOR_GAME_VERSION);
+  Generator g2(42, 0.3, VECTOR_GAME_VERSION);
+  g2.setVectorized(false);
+  vector<uint64_t> vectorBits;
+  vector<uint64_t> scalarBits;
+  bool matches = true;
+  for (int numRows : {1, 3, 4, 7, 8, 63, 64, 65, 100, 1000, 4099}) {
+    for (int column = 0; column < 20; column++) {
+      g1.generateColumn(column * 7919, numRows, vectorBits);
+      g2.generateColumn(column * 7919, numRows, scalarBits);
+      matches = matches && vectorBits == scalarBits;
+    }
+  }
+  t.check(matches, "Vector kernel doesn't match the scalar kernel");
+  t.check(g1.isRandomAccess(), "Vectorized generator doesn't claim random access");
+
+  // A column shouldn't depend on the height it is generated with
+  g1.generateColumn(5, 4099, vectorBits);
+  g2.generateColumn(5, 100, scalarBits);
+  t.check(vectorBits[0] == scalarBits[0] && ((vectorBits[1] ^ scalarBits[1]) & ((1ULL << 36) - 1)) == 0, "Rows depend on the height of the column");
+
+  // Count the walls, which should be close to the percent wall
+  int numWalls = 0;
+  for (int row = 0; row < 4099; row++) {
+    numWalls += (vectorBits[row / 64] >> (row % 64)) & 1;
+  }
+  t.check(numWalls > 1100 && numWalls < 1360, "Vectorized generator doesn't follow the percent wall");
+
+  // Percent walls of 0 and 1 should give all floors and all walls
+  Generator g3(42, 0, VECTOR_GAME_VERSION);
+  g3.generateColumn(7, 64, vectorBits);
+  t.check(vectorBits[0] == 0, "Percent wall of 0 generated a wall");
+  Generator g4(42, 1, VECTOR_GAME_VERSION);
+  g4.generateColumn(7, 64, vectorBits);
+  t.check(vectorBits[0] == ~0ULL, "Percent wall of 1 generated a floor");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test getCheckpoints() and setCheckpoints() for the legacy version
+bool generatorTests_checkpoints() {
+  // Start new testing object
+  Testing t("getCheckpoints() and setCheckpoints()");
+
+  // Generate columns in order past a few checkpoints
+  const int numRows = 5;
+  const int lastColumn = 3 * STREAM_CHECKPOINT_INTERVAL + 10;
+  Generator g1(42, 0.3, LEGACY_GAME_VERSION);
+  vector<vector<uint64_t>> expected(lastColumn + 1);
+  for (int column = 0; column <= lastColumn; column++) {
+    g1.generateColumn(column, numRows, expected[column]);
+  }
+  vector<StreamCheckpoint> checkpoints = g1.getCheckpoints();
+  t.check(checkpoints.size() == 3 && checkpoints[0].column == STREAM_CHECKPOINT_INTERVAL && checkpoints[2].column == 3 * STREAM_CHECKPOINT_INTERVAL && g1.getCheckpointRows() == numRows, "Checkpoints weren't taken every interval");
+
+  // A generator with the checkpoints should jump to any column and get the
+  // same walls, in any order
+  Generator g2(42, 0.3, LEGACY_GAME_VERSION);
+  g2.setCheckpoints(checkpoints, numRows);
+  vector<uint64_t> bits;
+  bool matches = true;
+  for (int column : {lastColumn, 5, 2 * STREAM_CHECKPOINT_INTERVAL, 2 * STREAM_CHECKPOINT_INTERVAL - 1, STREAM_CHECKPOINT_INTERVAL + 1, lastColumn - 1}) {
+    g2.generateColumn(column, numRows, bits);
+    matches = matches && bits == expected[column];
+  }
+  t.check(matches, "Columns generated from checkpoints don't match the stream");
+
+  // A generator without them should replay from the seed, and take the
+  // checkpoints along the way
+  Generator g3(42, 0.3, LEGACY_GAME_VERSION);
+  g3.generateColumn(lastColumn, numRows, bits);
+  t.check(bits == expected[lastColumn] && g3.getCheckpoints().size() == 3 && g3.getCheckpoints()[1].state == checkpoints[1].state, "Replaying from the seed didn't take the same checkpoints");
+
+  // Checkpoints that can't be read, or are for another height, should be
+  // ignored
+  vector<StreamCheckpoint> broken = checkpoints;
+  broken[2].state.resize(10);
+  Generator g4(42, 0.3, LEGACY_GAME_VERSION);
+  g4.setCheckpoints(broken, numRows);
+  g4.generateColumn(lastColumn, numRows, bits);
+  t.check(bits == expected[lastColumn], "Broken checkpoint was used");
+  Generator g5(42, 0.3, LEGACY_GAME_VERSION);
+  g5.setCheckpoints(checkpoints, numRows + 1);
+  g5.generateColumn(lastColumn, numRows, bits);
+  t.check(bits == expected[lastColumn] && g5.getCheckpointRows() == numRows, "Checkpoint for another height was used");
+
+  return t.getResult(); // Return pass or fail result
+}
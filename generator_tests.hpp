@@ -0,0 +1,42 @@
+#ifndef generator_tests_hpp
+#define generator_tests_hpp
+
+#include "generator.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool generatorTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests the legacy mt19937 stream generator
+*/
+bool generatorTests_legacy();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests the counter-based random access generator
+*/
+bool generatorTests_counter();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests the vectorized generator against its scalar kernel
+*/
+bool generatorTests_vector();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests getCheckpoints() and setCheckpoints() for the legacy version
+*/
+bool generatorTests_checkpoints();
+
+#endif
@@ -20,12 +20,25 @@ Point2D lastCursorPosition;
 // Store if the mouse right button is depressed
 bool isDragging;
 
-// Store the time when we last saved
-int lastSave;
+// Store the time when the last save finished writing
+long long lastSave;
+
+// Milliseconds between checks of a background save, and milliseconds the save
+// message is shown for
+const int SAVE_CHECK_INTERVAL = 50;
+const int SAVE_MESSAGE_DURATION = 1000;
 
 // Should we display the tutorial
 bool dispTutorial;
 
+// Store if a repaint was requested for cells of the board that changed, and
+// if one was requested for the whole window (for the messages on top of it)
+//  Note: the window is single buffered, so the last frame is still on the
+//  screen and only the changed cells have to be drawn over it. Repaints GLUT
+//  asks for itself (like when the window is uncovered) draw everything.
+bool isDamagePosted;
+bool isRepaintPosted;
+
 /**
 * Requires: Command line arguments, and a pointer to a gameboard
 * Modifies: everything
@@ -84,7 +97,7 @@ void startGUI(int argc, char **argv, GameBoard *g, bool dispTut) {
 
 /**
 * Requires: nothing
-* Modifies: isDragging lastCursorPosition
+* Modifies: isDragging, lastCursorPosition, isDamagePosted, and isRepaintPosted
 * Effects: Prepares the variables
 */
 void init() {
@@ -96,6 +109,9 @@ void init() {
   lastSave = 0;
   // Set tutorial toggle
   dispTutorial = false;
+  // Nothing is waiting to be repainted
+  isDamagePosted = false;
+  isRepaintPosted = false;
 }
 
 /**
@@ -114,8 +130,9 @@ void initGL() {
 * Effects: Prepares to exit the GUI
 */
 void exitGUI() {
-  // Save game
-  gameboard->saveGame();
+  // Save game, and wait for it (and any other background save) to be written
+  gameboard->saveGameAsync();
+  gameboard->waitForSaves();
 }
 
 /**
@@ -134,16 +151,24 @@ void display() {
   glLoadIdentity();
   glOrtho(0.0, gameboard->getGamePixelWidth(), gameboard->getGamePixelHeight(), 0.0, -1.f, 1.f);
 
-  // Clear the color buffer with background color
-  glClear(GL_COLOR_BUFFER_BIT);
+  // Only draw the changed cells over the last frame if that is all that was
+  // asked for, otherwise clear the color buffer with background color and
+  // draw everything
+  if (!isDamagePosted || isRepaintPosted) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    gameboard->damageAll();
+  }
+  isDamagePosted = false;
+  isRepaintPosted = false;
 
   // Enable plolygon front and back mode
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
   // Display the gameboard
-  gameboard->display();
+  gameboard->redraw();
 
   // Display if recently saved
+  lastSave = gameboard->finishSaves();
   displaySavedMessage();
 
   // Display Tutorial
@@ -153,14 +178,37 @@ void display() {
   glFlush();
 }
 
+/**
+* Requires: GLUT
+* Modifies: isDamagePosted and GLUT
+* Effects: Repaints the cells of the board that changed, if any did
+*/
+void postDamage() {
+  if (gameboard->hasDamage()) {
+    isDamagePosted = true;
+    glutPostRedisplay();
+  }
+}
+
+/**
+* Requires: GLUT
+* Modifies: isRepaintPosted and GLUT
+* Effects: Repaints the whole window
+*/
+void postRepaint() {
+  isRepaintPosted = true;
+  glutPostRedisplay();
+}
+
 /**
 * Requires: GLUT
 * Modifies: GLUT
 * Effects: Displays save message
 */
 void displaySavedMessage() {
-  // Take current time stamp and substract it from the last save to display for 3 seconds.
-  if (time(nullptr) - lastSave < 1) {
+  // Take current time stamp and substract it from the time the last save
+  // finished writing to display for a second.
+  if (lastSave > 0 && time(nullptr) - lastSave < 1) {
     string saveMessage = "Game Saved";
     glColor3f(1, 1, 1);
     glRasterPos2i(5, 18);
@@ -170,6 +218,24 @@ void displaySavedMessage() {
   }
 }
 
+/**
+* Requires: GLUT
+* Modifies: GLUT
+* Effects: Keeps checking the background save until it is written, then
+* repaints to show the save message, and again to hide it
+*/
+void checkSave(int isHiding) {
+  if (!isHiding && gameboard->isSaving()) {
+    // Nothing on the screen changes until the save is written
+    glutTimerFunc(SAVE_CHECK_INTERVAL, checkSave, 0);
+    return;
+  } else if (!isHiding) {
+    glutTimerFunc(SAVE_MESSAGE_DURATION, checkSave, 1);
+  }
+
+  postRepaint();
+}
+
 /**
 * Requires: GLUT
 * Modifies: GLUT
@@ -192,7 +258,8 @@ void displayTutorial() {
                         " 7.  Left click to create walls",
                         " 8.  Right click to delete walls",
                         " 9.  Drag walls with the mouse",
-                        " 10. Press T to show/hide this tutorial"};
+                        " 10. Press Z to undo and Y to redo",
+                        " 11. Press T to show/hide this tutorial"};
 
     // Display all the messages
     for (int i = 0; i < s.size(); i++) {
@@ -224,12 +291,27 @@ void kbd(unsigned char key, int x, int y) {
   // Display the tutorial with the t key
   if (key == 't') {
     dispTutorial = !dispTutorial;
+    postRepaint();
   }
 
   // Save the game with the s key
   if (key == 's') {
-    gameboard->saveGame();
-    lastSave = time(nullptr);
+    // Save in the background, and show the message once it is written
+    gameboard->saveGameAsync();
+    checkSave(0);
+  }
+
+  // Undo the last edit with the z key (or Ctrl+Z), and redo it with the y key
+  // (or Ctrl+Y), saving the cells it changed back
+  if (key == 'z' || key == 26) {
+    if (gameboard->undo()) {
+      gameboard->saveEdits();
+    }
+  }
+  if (key == 'y' || key == 25) {
+    if (gameboard->redo()) {
+      gameboard->saveEdits();
+    }
   }
 
   // Swap color with spacebar
@@ -250,7 +332,8 @@ void kbd(unsigned char key, int x, int y) {
     break;
   }
 
-  glutPostRedisplay();
+  // Repaint only if the board or player changed
+  postDamage();
 
   return;
 }
@@ -277,7 +360,8 @@ void kbdS(int key, int x, int y) {
     break;
   }
 
-  glutPostRedisplay();
+  // Repaint only if the board or player changed
+  postDamage();
 
   return;
 }
@@ -296,7 +380,8 @@ void cursor(int x, int y) {
     }
   }
 
-  glutPostRedisplay();
+  // Repaint only if the wall moved
+  postDamage();
 }
 
 /**
@@ -311,7 +396,8 @@ void mouse(int button, int state, int x, int y) {
   // Only for the left button
   if (button == GLUT_LEFT_BUTTON) {
     if (state == GLUT_DOWN) {
-      // Add a wall
+      // Add a wall, grouping it with the drag so they are undone as one
+      gameboard->beginEditGroup();
       gameboard->addWall(x, y);
       // On state down, enable dragging
       isDragging = true;
@@ -319,8 +405,13 @@ void mouse(int button, int state, int x, int y) {
     } else if (state == GLUT_UP) {
       // On state up, disable dragging
       isDragging = false;
-      // Save the game
-      gameboard->saveGame();
+      gameboard->endEditGroup();
+      // Save the cells changed by the click or drag (which compacts the edit
+      // journal in the background once it is full)
+      gameboard->saveEdits();
+      if (gameboard->isSaving()) {
+        checkSave(0);
+      }
     }
   }
 
@@ -329,11 +420,12 @@ void mouse(int button, int state, int x, int y) {
     if (state == GLUT_DOWN && !isDragging) {
       // Remove a wall
       if (gameboard->removeWall(x, y)) {
-        // Save the game
-        gameboard->saveGame();
+        // Save the removed wall
+        gameboard->saveEdits();
       }
     }
   }
 
-  glutPostRedisplay();
+  // Repaint only if a wall was added or removed
+  postDamage();
 }
\ No newline at end of file
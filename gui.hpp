@@ -25,7 +25,7 @@ void startGUI(int argc, char **argv, GameBoard *g, bool dispTut = false);
 
 /**
 * Requires: nothing
-* Modifies: isDragging lastCursorPosition
+* Modifies: isDragging, lastCursorPosition, isDamagePosted, and isRepaintPosted
 * Effects: Prepares the variables
 */
 void init();
@@ -54,6 +54,20 @@ void exitGUI();
 */
 void display(void);
 
+/**
+* Requires: GLUT
+* Modifies: isDamagePosted and GLUT
+* Effects: Repaints the cells of the board that changed, if any did
+*/
+void postDamage();
+
+/**
+* Requires: GLUT
+* Modifies: isRepaintPosted and GLUT
+* Effects: Repaints the whole window
+*/
+void postRepaint();
+
 /**
 * Requires: GLUT
 * Modifies: GLUT
@@ -61,6 +75,14 @@ void display(void);
 */
 void displaySavedMessage();
 
+/**
+* Requires: GLUT
+* Modifies: GLUT
+* Effects: Keeps checking the background save until it is written, then
+* repaints to show the save message, and again to hide it
+*/
+void checkSave(int isHiding);
+
 /**
 * Requires: GLUT
 * Modifies: GLUT
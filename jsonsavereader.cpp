@@ -0,0 +1,473 @@
+#include "jsonsavereader.hpp"
+#include "floor.hpp"
+#include "generator.hpp"
+#include "wall.hpp"
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+
+// Deepest nesting of values the reader skips over
+static const int MAX_SKIP_DEPTH = 256;
+
+/**
+* Requires: a stream with a JSON save, and a positive read size
+* Modifies: in, buffer
+* Effects: Creates a reader for the stream
+*/
+JsonSaveReader::JsonSaveReader(istream &i, int readSize) : in(i), buffer(max(1, readSize)) {
+  next = 0;
+  end = 0;
+  depth = 0;
+}
+
+/**
+* Requires: a function to read the value of each key (or each item) that
+* returns if it was valid
+* Modifies: the stream
+* Effects: Reads an object (or array), returns if it was valid
+*/
+template <class ReadKey> bool JsonSaveReader::readObject(ReadKey readKey) {
+  if (!accept('{')) {
+    return fail("an object");
+  }
+  if (accept('}')) {
+    return true;
+  }
+
+  string key;
+  do {
+    if (!readString(key) || !(accept(':') || fail("':'")) || !readKey(key)) {
+      return false;
+    }
+  } while (accept(','));
+
+  return accept('}') || fail("'}'");
+}
+template <class ReadItem> bool JsonSaveReader::readArray(ReadItem readItem) {
+  if (!accept('[')) {
+    return fail("an array");
+  }
+  if (accept(']')) {
+    return true;
+  }
+
+  do {
+    if (!readItem()) {
+      return false;
+    }
+  } while (accept(','));
+
+  return accept(']') || fail("']'");
+}
+
+/**
+* Requires: nothing
+* Modifies: data and the stream
+* Effects: Reads the save into the data, returns if it was valid (saves
+* without a game version are from the first version)
+*/
+bool JsonSaveReader::read(SaveData &data) {
+  // Fill in the optional fields
+  data.gameVersion = LEGACY_GAME_VERSION;
+  data.saveTime = 0;
+  data.leftDisplayEdge = 0;
+  data.changes.clear();
+  data.checkpoints.clear();
+
+  // Read the fields we know, and skip the rest
+  bool hasDimensions[4] = {false, false, false, false};
+  bool hasSeed = false;
+  bool hasPercentWall = false;
+  bool hasPlayer = false;
+  bool isValid = readObject([&](const string &key) {
+    if (key == "gameVersion") {
+      return readInt(data.gameVersion);
+    } else if (key == "saveTime") {
+      double saveTime;
+      bool isRead = readNumber(saveTime);
+      data.saveTime = static_cast<long long>(saveTime);
+      return isRead;
+    } else if (key == "numBlocksWide") {
+      return (hasDimensions[0] = readInt(data.numBlocksWide));
+    } else if (key == "numBlocksHigh") {
+      return (hasDimensions[1] = readInt(data.numBlocksHigh));
+    } else if (key == "blockWidth") {
+      return (hasDimensions[2] = readInt(data.blockWidth));
+    } else if (key == "blockHeight") {
+      return (hasDimensions[3] = readInt(data.blockHeight));
+    } else if (key == "leftDisplayEdge") {
+      return readInt(data.leftDisplayEdge);
+    } else if (key == "seed") {
+      return (hasSeed = readInt(data.seed));
+    } else if (key == "percentWall") {
+      return (hasPercentWall = readNumber(data.percentWall));
+    } else if (key == "player") {
+      return (hasPlayer = readPlayer(data.player));
+    } else if (key == "changes") {
+      // Saves without changes may have null instead of an array
+      skipSpace();
+      if (peek() == 'n') {
+        return skipValue();
+      }
+      return readArray([&]() { return readChange(data.changes); });
+    } else if (key == "streamCheckpoints") {
+      return readArray([&]() { return readCheckpoint(data.checkpoints); });
+    }
+    return skipValue();
+  });
+  if (!isValid) {
+    return false;
+  }
+
+  // Only whitespace can follow the save
+  skipSpace();
+  if (peek() != -1) {
+    return fail("the end of the file");
+  }
+
+  // Make sure the required fields were there
+  if (!(hasDimensions[0] && hasDimensions[1] && hasDimensions[2] && hasDimensions[3])) {
+    return fail("the game dimensions");
+  } else if (!hasSeed) {
+    return fail("the seed");
+  } else if (!hasPercentWall) {
+    return fail("the percentages");
+  } else if (!hasPlayer) {
+    return fail("the player");
+  }
+
+  return true;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns what was wrong with the save, if it wasn't valid
+*/
+const string &JsonSaveReader::getError() const {
+  return error;
+}
+
+/**
+* Requires: nothing
+* Modifies: buffer, next, and end
+* Effects: Returns the next character without using it (or -1 at the end of
+* the stream), or uses and returns it
+*/
+int JsonSaveReader::peek() {
+  if (next == end) {
+    // Read the next piece of the stream
+    in.read(buffer.data(), buffer.size());
+    next = 0;
+    end = in.gcount();
+    if (end == 0) {
+      return -1;
+    }
+  }
+  return static_cast<unsigned char>(buffer[next]);
+}
+int JsonSaveReader::get() {
+  int c = peek();
+  if (c != -1) {
+    next++;
+  }
+  return c;
+}
+
+/**
+* Requires: nothing
+* Modifies: the stream
+* Effects: Skips whitespace
+*/
+void JsonSaveReader::skipSpace() {
+  while (peek() == ' ' || peek() == '\n' || peek() == '\r' || peek() == '\t') {
+    next++;
+  }
+}
+
+/**
+* Requires: nothing
+* Modifies: the stream
+* Effects: Skips whitespace, then uses the character if it is c, returns if
+* it was
+*/
+bool JsonSaveReader::accept(char c) {
+  skipSpace();
+  if (peek() == static_cast<unsigned char>(c)) {
+    next++;
+    return true;
+  }
+  return false;
+}
+
+/**
+* Requires: what was expected
+* Modifies: error
+* Effects: Remembers the first problem with the save, and returns false
+*/
+bool JsonSaveReader::fail(const string &expected) {
+  if (error.empty()) {
+    error = "Expected " + expected;
+  }
+  return false;
+}
+
+/**
+* Requires: nothing
+* Modifies: the stream and value
+* Effects: Reads the value of the type, returns if it was valid
+*/
+bool JsonSaveReader::readString(string &value) {
+  if (!accept('"')) {
+    return fail("a string");
+  }
+
+  value.clear();
+  while (true) {
+    int c = get();
+    if (c == -1 || c < 0x20) {
+      return fail("the end of a string");
+    } else if (c == '"') {
+      return true;
+    } else if (c == '\\') {
+      // Keep simple escapes, and replace the unicode ones (which never appear
+      // in the keys we know) with their last byte
+      c = get();
+      switch (c) {
+      case 'b':
+        value += '\b';
+        break;
+      case 'f':
+        value += '\f';
+        break;
+      case 'n':
+        value += '\n';
+        break;
+      case 'r':
+        value += '\r';
+        break;
+      case 't':
+        value += '\t';
+        break;
+      case 'u': {
+        int code = 0;
+        for (int i = 0; i < 4; i++) {
+          c = get();
+          if (!isxdigit(c)) {
+            return fail("a unicode escape");
+          }
+          code = code * 16 + (isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+        }
+        value += static_cast<char>(code);
+        break;
+      }
+      case '"':
+      case '\\':
+      case '/':
+        value += static_cast<char>(c);
+        break;
+      default:
+        return fail("an escape");
+      }
+    } else {
+      value += static_cast<char>(c);
+    }
+  }
+}
+bool JsonSaveReader::readNumber(double &value) {
+  skipSpace();
+
+  // Copy the characters of the number, which are never long in a save
+  char text[64];
+  size_t length = 0;
+  int c = peek();
+  while (length + 1 < sizeof(text) && (isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+    text[length++] = static_cast<char>(get());
+    c = peek();
+  }
+  text[length] = '\0';
+
+  // Convert them, and make sure they were all used
+  char *used;
+  value = strtod(text, &used);
+  if (length == 0 || used != text + length) {
+    return fail("a number");
+  }
+  return true;
+}
+bool JsonSaveReader::readInt(int &value) {
+  double number;
+  if (!readNumber(number) || number < INT_MIN || number > INT_MAX) {
+    return fail("an integer");
+  }
+  value = static_cast<int>(number);
+  return true;
+}
+bool JsonSaveReader::readColor(Color &value) {
+  bool hasChannels[3] = {false, false, false};
+  bool isValid = readObject([&](const string &key) {
+    if (key == "r") {
+      return (hasChannels[0] = readNumber(value.r));
+    } else if (key == "g") {
+      return (hasChannels[1] = readNumber(value.g));
+    } else if (key == "b") {
+      return (hasChannels[2] = readNumber(value.b));
+    }
+    return skipValue();
+  });
+  return isValid && (hasChannels[0] && hasChannels[1] && hasChannels[2] ? true : fail("a color with r, g, and b"));
+}
+bool JsonSaveReader::readPlayer(Player &value) {
+  Color color;
+  Color alternateColor;
+  int vector[2];
+  bool hasFields[4] = {false, false, false, false};
+  bool isValid = readObject([&](const string &key) {
+    if (key == "color") {
+      return (hasFields[0] = readColor(color));
+    } else if (key == "alternateColor") {
+      return (hasFields[1] = readColor(alternateColor));
+    } else if (key == "vectorX") {
+      return (hasFields[2] = readInt(vector[0]));
+    } else if (key == "vectorY") {
+      return (hasFields[3] = readInt(vector[1]));
+    }
+    return skipValue();
+  });
+  if (!isValid || !(hasFields[0] && hasFields[1] && hasFields[2] && hasFields[3])) {
+    return fail("a player with colors and a position");
+  }
+
+  value.setColor(color);
+  value.setAlternateColor(alternateColor);
+  value.setVectorX(vector[0]);
+  value.setVectorY(vector[1]);
+  return true;
+}
+
+/**
+* Requires: nothing
+* Modifies: the stream and changes
+* Effects: Reads a change, and stores its tile if it is a wall or floor on
+* the board, returns if it was valid
+*/
+bool JsonSaveReader::readChange(ChangeMap &changes) {
+  Color color;
+  int column;
+  int row;
+  int type;
+  int floorType;
+  bool hasFields[5] = {false, false, false, false, false};
+  bool isValid = readObject([&](const string &key) {
+    if (key == "color") {
+      return (hasFields[0] = readColor(color));
+    } else if (key == "column") {
+      return (hasFields[1] = readInt(column));
+    } else if (key == "row") {
+      return (hasFields[2] = readInt(row));
+    } else if (key == "type") {
+      return (hasFields[3] = readInt(type));
+    } else if (key == "floorType") {
+      return (hasFields[4] = readInt(floorType));
+    }
+    return skipValue();
+  });
+  if (!isValid || !(hasFields[1] && hasFields[2] && hasFields[3])) {
+    return fail("a change with a column, row, and type");
+  }
+
+  // Skip changes outside of the board
+  if (column < 0 || row < 0) {
+    return true;
+  }
+
+  // Store the tile for the change, the same way as the block would load it
+  if (type == WallBlock) {
+    if (!hasFields[0]) {
+      return fail("a wall with a color");
+    }
+    Wall wall;
+    wall.setColor(color);
+    changes.setChange(column, row, tileFromBlock(wall));
+  } else if (type == FloorBlock) {
+    if (!hasFields[0] || !hasFields[4]) {
+      return fail("a floor with a color and floor type");
+    }
+    Floor floor;
+    floor.setColor(color);
+    floor.setFloorType(static_cast<FloorType>(floorType));
+    changes.setChange(column, row, tileFromBlock(floor));
+  }
+  return true;
+}
+
+/**
+* Requires: nothing
+* Modifies: the stream and checkpoints
+* Effects: Reads a checkpoint of the stream, and adds it to the checkpoints,
+* returns if it was valid
+*/
+bool JsonSaveReader::readCheckpoint(vector<StreamCheckpoint> &checkpoints) {
+  StreamCheckpoint checkpoint;
+  bool hasFields[2] = {false, false};
+  bool isValid = readObject([&](const string &key) {
+    if (key == "column") {
+      return (hasFields[0] = readInt(checkpoint.column));
+    } else if (key == "state") {
+      return (hasFields[1] = readArray([&]() {
+                double word;
+                if (!readNumber(word) || word < 0 || word > UINT32_MAX) {
+                  return fail("a 32 bit number");
+                }
+                checkpoint.state.push_back(static_cast<uint32_t>(word));
+                return true;
+              }));
+    }
+    return skipValue();
+  });
+  if (!isValid || !(hasFields[0] && hasFields[1])) {
+    return fail("a checkpoint with a column and state");
+  }
+
+  checkpoints.push_back(move(checkpoint));
+  return true;
+}
+
+/**
+* Requires: nothing
+* Modifies: the stream
+* Effects: Reads a value of any type without storing it, returns if it was
+* valid
+*/
+bool JsonSaveReader::skipValue() {
+  // Don't let deeply nested values run out of stack
+  if (depth >= MAX_SKIP_DEPTH) {
+    return fail("less deeply nested values");
+  }
+
+  skipSpace();
+  int c = peek();
+  bool isValid;
+  depth++;
+  if (c == '"') {
+    string value;
+    isValid = readString(value);
+  } else if (c == '{') {
+    isValid = readObject([&](const string &) { return skipValue(); });
+  } else if (c == '[') {
+    isValid = readArray([&]() { return skipValue(); });
+  } else if (c == 't' || c == 'f' || c == 'n') {
+    // Read the literal
+    const string literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+    isValid = true;
+    for (char expected : literal) {
+      isValid = isValid && get() == expected;
+    }
+    isValid = isValid || fail(literal);
+  } else {
+    double value;
+    isValid = readNumber(value);
+  }
+  depth--;
+  return isValid;
+}
@@ -0,0 +1,130 @@
+#ifndef jsonsavereader_hpp
+#define jsonsavereader_hpp
+
+#include "savefile.hpp"
+#include <istream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Number of bytes read from the stream at a time
+const int JSON_SAVE_READ_SIZE = 1 << 16;
+
+// Reads a JSON save a piece at a time, storing each change as soon as it is
+// read instead of building the whole document first, so memory doesn't grow
+// with the size of the file (besides the changes themselves)
+class JsonSaveReader {
+public:
+  /**
+  * Requires: a stream with a JSON save, and a positive read size
+  * Modifies: in, buffer
+  * Effects: Creates a reader for the stream
+  */
+  JsonSaveReader(istream &i, int readSize = JSON_SAVE_READ_SIZE);
+
+  /**
+  * Requires: nothing
+  * Modifies: data and the stream
+  * Effects: Reads the save into the data, returns if it was valid (saves
+  * without a game version are from the first version)
+  */
+  bool read(SaveData &data);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns what was wrong with the save, if it wasn't valid
+  */
+  const string &getError() const;
+
+private:
+  // Store the stream, and the bytes read from it that haven't been used yet
+  istream &in;
+  vector<char> buffer;
+  size_t next;
+  size_t end;
+
+  // Store the first problem with the save
+  string error;
+
+  // Store how deep the reader is in nested values it skips
+  int depth;
+
+  /**
+  * Requires: nothing
+  * Modifies: buffer, next, and end
+  * Effects: Returns the next character without using it (or -1 at the end of
+  * the stream), or uses and returns it
+  */
+  int peek();
+  int get();
+
+  /**
+  * Requires: nothing
+  * Modifies: the stream
+  * Effects: Skips whitespace
+  */
+  void skipSpace();
+
+  /**
+  * Requires: nothing
+  * Modifies: the stream
+  * Effects: Skips whitespace, then uses the character if it is c, returns if
+  * it was
+  */
+  bool accept(char c);
+
+  /**
+  * Requires: what was expected
+  * Modifies: error
+  * Effects: Remembers the first problem with the save, and returns false
+  */
+  bool fail(const string &expected);
+
+  /**
+  * Requires: nothing
+  * Modifies: the stream and value
+  * Effects: Reads the value of the type, returns if it was valid
+  */
+  bool readString(string &value);
+  bool readNumber(double &value);
+  bool readInt(int &value);
+  bool readColor(Color &value);
+  bool readPlayer(Player &value);
+
+  /**
+  * Requires: nothing
+  * Modifies: the stream and changes
+  * Effects: Reads a change, and stores its tile if it is a wall or floor on
+  * the board, returns if it was valid
+  */
+  bool readChange(ChangeMap &changes);
+
+  /**
+  * Requires: nothing
+  * Modifies: the stream and checkpoints
+  * Effects: Reads a checkpoint of the stream, and adds it to the checkpoints,
+  * returns if it was valid
+  */
+  bool readCheckpoint(vector<StreamCheckpoint> &checkpoints);
+
+  /**
+  * Requires: nothing
+  * Modifies: the stream
+  * Effects: Reads a value of any type without storing it, returns if it was
+  * valid
+  */
+  bool skipValue();
+
+  /**
+  * Requires: a function to read the value of each key (or each item) that
+  * returns if it was valid
+  * Modifies: the stream
+  * Effects: Reads an object (or array), returns if it was valid
+  */
+  template <class ReadKey> bool readObject(ReadKey readKey);
+  template <class ReadItem> bool readArray(ReadItem readItem);
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "jsonsavereader_tests.hpp"
+#include "floor.hpp"
+#include "generator.hpp"
+#include "wall.hpp"
+#include <sstream>
+
+// Save with every field, in an unusual order, with unknown fields and odd
+// spacing the reader should get through
+static const string TEST_SAVE = "{\"extra\": [1, {\"a\": [true, false, null]}, \"\\\"x\\u0041\"],\n"
+                                "\t\"seed\" : -42, \"percentWall\": 3.5e-1, \"numBlocksWide\": 30, \"numBlocksHigh\": 20,\r\n"
+                                "\"blockWidth\": 25, \"blockHeight\": 26, \"leftDisplayEdge\": 7, \"gameVersion\": 2, \"saveTime\": 1500000000,\n"
+                                "\"player\": {\"type\": 1, \"vectorX\": 9, \"vectorY\": 3, \"color\": {\"r\": 0.1, \"g\": 0.2, \"b\": 0.3}, \"alternateColor\": {\"b\": 0.6, \"g\": 0.5, \"r\": 0.4}},\n"
+                                "\"changes\": [{\"column\": 1, \"row\": 2, \"type\": 3, \"color\": {\"r\": 0.7, \"g\": 0.8, \"b\": 0.9}},\n"
+                                "  {\"type\": 2, \"floorType\": 2, \"color\": {\"r\": 0, \"g\": 0, \"b\": 0}, \"row\": 0, \"column\": 0},\n"
+                                "  {\"column\": -1, \"row\": 0, \"type\": 3, \"color\": {\"r\": 0, \"g\": 0, \"b\": 0}},\n"
+                                "  {\"column\": 4, \"row\": 4, \"type\": 1}]}\n";
+
+/**
+* Requires: the text of a save, and a read size
+* Modifies: data
+* Effects: Reads the save from the text, returns if it was valid
+*/
+static bool readSave(const string &text, SaveData &data, int readSize = JSON_SAVE_READ_SIZE, string *error = nullptr) {
+  istringstream stream(text);
+  JsonSaveReader reader(stream, readSize);
+  bool isValid = reader.read(data);
+  if (error) {
+    *error = reader.getError();
+  }
+  return isValid;
+}
+
+bool jsonSaveReaderTests_run() {
+  cout << "Running JSON Save Reader Tests:" << endl;
+  cout << "-------------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(jsonSaveReaderTests_read());
+  t.check(jsonSaveReaderTests_invalid());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test read() on valid saves
+bool jsonSaveReaderTests_read() {
+  // Start new testing object
+  Testing t("read()");
+
+  // Read every field of the test save
+  SaveData data;
+  t.check(readSave(TEST_SAVE, data), "Valid save couldn't be read");
+  t.check(data.gameVersion == 2 && data.saveTime == 1500000000 && data.numBlocksWide == 30 && data.numBlocksHigh == 20 && data.blockWidth == 25 && data.blockHeight == 26, "Header wasn't read");
+  t.check(data.leftDisplayEdge == 7 && data.seed == -42 && data.percentWall == 0.35, "Seed and position weren't read");
+  t.check(data.player.getColor().g == 0.2 && data.player.getAlternateColor().r == 0.4 && data.player.getVectorX() == 9 && data.player.getVectorY() == 3, "Player wasn't read");
+
+  // Walls keep their color and floors take it from their type, and changes
+  // off the board or of other types are skipped
+  Wall wall;
+  wall.setColor({0.7, 0.8, 0.9});
+  ChangeMap expected;
+  expected.setChange(1, 2, tileFromBlock(wall));
+  expected.setChange(0, 0, tileFromBlock(Floor(SandFloor)));
+  t.check(data.changes == expected, "Changes weren't read");
+
+  // Reading a byte at a time should give the same save
+  SaveData small;
+  t.check(readSave(TEST_SAVE, small, 1) && small.changes == expected && small.seed == -42 && small.player.getVectorX() == 9, "Save read a byte at a time was different");
+
+  // Optional fields should get their defaults
+  SaveData minimal;
+  t.check(readSave("{\"numBlocksWide\":1,\"numBlocksHigh\":2,\"blockWidth\":3,\"blockHeight\":4,\"seed\":5,\"percentWall\":0,\"changes\":null,"
+                   "\"player\":{\"color\":{\"r\":0,\"g\":0,\"b\":0},\"alternateColor\":{\"r\":0,\"g\":0,\"b\":0},\"vectorX\":0,\"vectorY\":0}}",
+                   minimal) &&
+              minimal.gameVersion == LEGACY_GAME_VERSION && minimal.leftDisplayEdge == 0 && minimal.changes.empty(),
+          "Optional fields didn't get their defaults");
+
+  // A save encoded as JSON should read back the same
+  data.changes.setChange(1000000, 4999, tileFromBlock(Floor(DirtFloor)));
+  SaveData encoded;
+  t.check(readSave(encodeJsonSave(data), encoded, 7) && encoded.changes == data.changes && encoded.percentWall == data.percentWall && encoded.player.getAlternateColor().b == 0.6, "Encoded save didn't read back");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test read() rejecting invalid saves, and getError()
+bool jsonSaveReaderTests_invalid() {
+  // Start new testing object
+  Testing t("read() of invalid saves");
+
+  // Every cut off save should be rejected
+  SaveData data;
+  bool rejected = true;
+  string trimmed = TEST_SAVE.substr(0, TEST_SAVE.find_last_of('}') + 1);
+  for (size_t size = 0; size < trimmed.size(); size++) {
+    rejected = rejected && !readSave(trimmed.substr(0, size), data);
+  }
+  t.check(rejected, "Cut off save was read");
+
+  // Missing fields and bad values should be rejected with a reason
+  string error;
+  t.check(!readSave("{\"seed\": 1}", data, JSON_SAVE_READ_SIZE, &error) && error == "Expected the game dimensions", "Save without dimensions was read");
+  t.check(!readSave(TEST_SAVE + "x", data, JSON_SAVE_READ_SIZE, &error) && error == "Expected the end of the file", "Save with trailing text was read");
+  t.check(!readSave("{\"seed\": 1e}", data) && !readSave("{\"seed\": tru}", data) && !readSave("{\"seed\" 1}", data) && !readSave("{\"seed\": 1,}", data), "Save with bad syntax was read");
+  t.check(!readSave("{\"changes\": [{\"column\": 0, \"row\": 0, \"type\": 3}]}", data, JSON_SAVE_READ_SIZE, &error) && error == "Expected a wall with a color", "Wall without a color was read");
+  t.check(!readSave("{\"seed\": 1e100}", data, JSON_SAVE_READ_SIZE, &error) && error == "Expected an integer", "Seed out of range was read");
+
+  // Deeply nested values shouldn't run out of stack
+  t.check(!readSave("{\"extra\": " + string(100000, '[') + "}", data, JSON_SAVE_READ_SIZE, &error) && error == "Expected less deeply nested values", "Deeply nested save was read");
+
+  return t.getResult(); // Return pass or fail result
+}
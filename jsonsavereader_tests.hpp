@@ -0,0 +1,28 @@
+#ifndef jsonsavereader_tests_hpp
+#define jsonsavereader_tests_hpp
+
+#include "jsonsavereader.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool jsonSaveReaderTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests read() on valid saves
+*/
+bool jsonSaveReaderTests_read();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests read() rejecting invalid saves, and getError()
+*/
+bool jsonSaveReaderTests_invalid();
+
+#endif
@@ -1,15 +1,28 @@
+#include <chrono>
 #include <experimental/filesystem> // Only available in C++17. See notes for special compile configurations per system.
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <math.h>
 #include <string>
 
 #include "block_tests.hpp"
+#include "changemap_tests.hpp"
+#include "compression_tests.hpp"
+#include "editjournal_tests.hpp"
 #include "floor_tests.hpp"
+#include "framebuffer.hpp"
+#include "framebuffer_tests.hpp"
 #include "gameboard.hpp"
 #include "gameboard_tests.hpp"
+#include "generator_tests.hpp"
 #include "gui.hpp"
+#include "jsonsavereader_tests.hpp"
 #include "player_tests.hpp"
+#include "savefile_tests.hpp"
+#include "savewriter_tests.hpp"
+#include "tilemesh_tests.hpp"
+#include "tilestore_tests.hpp"
 #include "wall_tests.hpp"
 
 using namespace std;
@@ -18,12 +31,17 @@ using namespace experimental::filesystem;
 // These methods are defined below
 void runTests();
 void runGUI(int argc, char **argv);
+bool runBenchmark(const string &filename);
+bool runRender(const string &filename, const string &imageFilename);
 
 // Structure the file metadata
 struct FileMetadata {
-  string shortName;          // Part before .infinity.json
+  string shortName;          // Part before the save extension
+  string extension;          // .infinity.bin or .infinity.json
   string lastModifiedString; // Human readable string
   long int lastModifiedInt;  // Unix timestamp
+  bool hasSummary;           // If the summary could be read
+  SaveSummary summary;       // Seed, player position, and number of edits
 };
 
 /**
@@ -38,6 +56,25 @@ int main(int argc, char **argv) {
   } else if (argc > 1 && string(argv[1]) == "gui") {
     // Run GUI
     runGUI(argc, argv);
+  } else if (argc > 2 && string(argv[1]) == "benchmark") {
+    // Compare the size and speed of a save with and without compression
+    if (!runBenchmark(argv[2])) {
+      cout << "Error reading '" << argv[2] << "'" << endl;
+      return EXIT_FAILURE;
+    }
+  } else if (argc > 3 && string(argv[1]) == "export") {
+    // Export a save file as JSON
+    GameBoard g;
+    if (!g.loadGame(argv[2]) || !g.exportGame(argv[3])) {
+      cout << "Error exporting '" << argv[2] << "' to '" << argv[3] << "'" << endl;
+      return EXIT_FAILURE;
+    }
+  } else if (argc > 3 && string(argv[1]) == "render") {
+    // Draw a save without a window, and write the frame as a PPM image
+    if (!runRender(argv[2], argv[3])) {
+      cout << "Error rendering '" << argv[2] << "' to '" << argv[3] << "'" << endl;
+      return EXIT_FAILURE;
+    }
   } else {
     // Present the user with the options
     cout << "Would you like to: " << endl << " 1) Launch the game" << endl << " 2) Run tests" << endl << "Please enter your choice: ";
@@ -112,6 +149,46 @@ void runTests() {
 
   cout << endl << "--------------------------------------------" << endl << endl;
 
+  t.check(generatorTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(tileStoreTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(tileMeshTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(changeMapTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(saveFileTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(editJournalTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(saveWriterTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(jsonSaveReaderTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(compressionTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
+  t.check(framebufferTests_run());
+
+  cout << endl << "--------------------------------------------" << endl << endl;
+
   // Display pass or fail result
   if (t.getResult()) {
     cout << "*** Done testing. All " << t.getNumTested() << " test sections passed! ***" << endl;
@@ -121,6 +198,93 @@ void runTests() {
   }
 }
 
+/**
+* Requires: a valid path to an existing game file (binary or JSON)
+* Modifies: nothing
+* Effects: Prints the size of the save in the binary layout with and without
+* compression, and how fast each is encoded and decoded, returns load status
+*/
+bool runBenchmark(const string &filename) {
+  // Read every change of the save
+  SaveData data;
+  if (isBinarySave(filename)) {
+    if (!readBinarySave(filename, data)) {
+      return false;
+    }
+  } else {
+    ifstream file(filename);
+    if (!file || !JsonSaveReader(file).read(data)) {
+      return false;
+    }
+  }
+
+  // Returns the seconds one run of the action takes, running it for at least
+  // a quarter of a second
+  auto timeAction = [](auto action) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int numRuns = 0;
+    double seconds = 0;
+    while (numRuns == 0 || seconds < 0.25) {
+      action();
+      numRuns++;
+      seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    return seconds / numRuns;
+  };
+
+  cout << countChanges(data) << " changes" << endl;
+  cout << left << setw(14) << "Layout" << setw(14) << "Bytes" << setw(10) << "Ratio" << setw(16) << "Encode MB/s"
+       << "Decode MB/s" << endl;
+
+  // Measure throughput against the size of the save without compression
+  size_t plainSize = 0;
+  for (bool isCompressed : {false, true}) {
+    data.isCompressed = isCompressed;
+    vector<uint8_t> bytes = encodeBinarySave(data);
+    if (!isCompressed) {
+      plainSize = bytes.size();
+    }
+    double encodeSeconds = timeAction([&data]() { encodeBinarySave(data); });
+    SaveData decoded;
+    double decodeSeconds = timeAction([&bytes, &decoded]() { decodeBinarySave(bytes.data(), bytes.size(), decoded); });
+    cout << left << setw(14) << (isCompressed ? "compressed" : "plain") << setw(14) << bytes.size() << setw(10) << fixed << setprecision(2) << plainSize / (double)bytes.size() << setw(16) << setprecision(1) << plainSize / encodeSeconds / 1e6 << plainSize / decodeSeconds / 1e6 << endl;
+  }
+
+  return true;
+}
+
+/**
+* Requires: a valid path to an existing game file (binary or JSON), and a
+* path to write the image to
+* Modifies: the image file
+* Effects: Draws the save the way the game shows it into a framebuffer, prints
+* the work and time one frame takes, and writes it as a PPM image, returns
+* render status
+*/
+bool runRender(const string &filename, const string &imageFilename) {
+  GameBoard g;
+  if (!g.loadGame(filename)) {
+    return false;
+  }
+
+  // Draw frames for at least a quarter of a second, so the time is steady
+  FrameBuffer frame;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  int numFrames = 0;
+  double seconds = 0;
+  while (numFrames == 0 || seconds < 0.25) {
+    g.display(frame);
+    numFrames++;
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+
+  // The rectangles and pixels are the same on every machine, the time isn't
+  cout << frame.getWidth() << "x" << frame.getHeight() << " pixels, " << frame.getNumRects() << " rectangles, " << frame.getNumFilled() << " pixels filled per frame" << endl;
+  cout << fixed << setprecision(3) << seconds * 1000 / numFrames << " ms per frame" << endl;
+
+  return frame.writePpm(imageFilename);
+}
+
 /**
 * Requires: The command line arguments
 * Modifies: nothing
@@ -138,8 +302,9 @@ void runGUI(int argc, char **argv) {
     // Get the path as a string
     string path = p.path().string();
 
-    // Try to find game files
-    string::size_type found = path.rfind(".infinity.json");
+    // Try to find game files, binary or JSON
+    string extension = hasSaveExtension(path, BINARY_SAVE_EXTENSION) ? BINARY_SAVE_EXTENSION : JSON_SAVE_EXTENSION;
+    string::size_type found = hasSaveExtension(path, extension) ? path.size() - extension.size() : string::npos;
 
     // If the file is a game file, add it to the vector
     if (found != string::npos) {
@@ -152,8 +317,12 @@ void runGUI(int argc, char **argv) {
       // Create the filename from the path string
       string filename = path.substr(0, found).substr(2);
 
+      // Read the summary from the header of the save (or its summary file)
+      SaveSummary summary;
+      bool hasSummary = readSaveSummary(path, summary);
+
       // Add to the vector
-      saveFiles.push_back({filename, lastModifiedString, static_cast<long int>(lastModifiedStringTime)});
+      saveFiles.push_back({filename, extension, lastModifiedString, static_cast<long int>(lastModifiedStringTime), hasSummary, summary});
 
       // Update the longest name
       if (filename.length() > longestName) {
@@ -213,12 +382,19 @@ void runGUI(int argc, char **argv) {
       cout << endl << "Please choose the game file you would like to load: " << endl;
 
       // Print the header
-      cout << " " << right << setw(log10(saveFiles.size()) + 4) << "#  " << left << setw(longestName + 5) << "Filename"
-           << "Last Modified" << endl;
+      cout << " " << right << setw(log10(saveFiles.size()) + 4) << "#  " << left << setw(longestName + 5) << "Filename" << setw(22) << "Last Modified" << setw(13) << "Seed" << setw(20) << "Position"
+           << "Edits" << endl;
 
       // Print all the game files
       for (int i = 0; i < saveFiles.size(); i++) {
-        cout << " " << right << setw(log10(saveFiles.size()) + 4) << to_string(i) + ": " << left << setw(longestName + 5) << saveFiles[i].shortName << saveFiles[i].lastModifiedString << endl;
+        const FileMetadata &file = saveFiles[i];
+        cout << " " << right << setw(log10(saveFiles.size()) + 4) << to_string(i) + ": " << left << setw(longestName + 5) << file.shortName << setw(22) << file.lastModifiedString;
+        if (file.hasSummary) {
+          cout << setw(13) << file.summary.seed << setw(20) << "(" + to_string(file.summary.playerX) + ", " + to_string(file.summary.playerY) + ")" << setw(10) << file.summary.numChanges;
+        } else {
+          cout << setw(43) << "(couldn't read the save)";
+        }
+        cout << (file.extension == JSON_SAVE_EXTENSION ? " (JSON)" : "") << endl;
       }
 
       cout << "Please enter your choice #: ";
@@ -238,9 +414,10 @@ void runGUI(int argc, char **argv) {
     }
 
     // Load the chosen game
-    cout << endl << "Loading '" << saveFiles[fileChoice].shortName + ".infinity.json'..." << endl;
-    if (g.loadGame(saveFiles[fileChoice].shortName + ".infinity.json")) {
+    cout << endl << "Loading '" << saveFiles[fileChoice].shortName + saveFiles[fileChoice].extension + "'..." << endl;
+    if (g.loadGame(saveFiles[fileChoice].shortName + saveFiles[fileChoice].extension)) {
       cout << "Game loaded!" << endl;
+      cout << "Generated the board in " << g.getGenerateSeconds() * 1000 << " ms" << endl;
       cout << "Launching Infinity..." << endl;
 
       // Start the game
@@ -0,0 +1,104 @@
+#include "mappedfile.hpp"
+#include <fstream>
+#include <iterator>
+
+// Files are mapped into memory where mmap is available
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Creates a view without a file
+*/
+MappedFile::MappedFile() {
+  data = nullptr;
+  size = 0;
+}
+
+/**
+* Requires: nothing
+* Modifies: the mapping
+* Effects: Unmaps the file
+*/
+MappedFile::~MappedFile() {
+  close();
+}
+
+/**
+* Requires: a valid path to an existing file
+* Modifies: everything
+* Effects: Maps the file (dropping the file that was mapped before), returns
+* if it could be mapped (empty files can't be)
+*/
+bool MappedFile::open(const string &filename) {
+  close();
+
+#ifdef _WIN32
+  // Read the whole file, since there is no mmap
+  ifstream file(filename, ios::binary);
+  bytes.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  if (!file || bytes.empty()) {
+    bytes.clear();
+    return false;
+  }
+  data = bytes.data();
+  size = bytes.size();
+  return true;
+#else
+  // Open the file and find its size
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // Map the file (the mapping keeps the file open after the descriptor is
+  // closed)
+  void *mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+  data = static_cast<const uint8_t *>(mapped);
+  size = status.st_size;
+  return true;
+#endif
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the bytes of the file (or nullptr if there isn't one), or
+* the number of them
+*/
+const uint8_t *MappedFile::getData() const {
+  return data;
+}
+size_t MappedFile::getSize() const {
+  return size;
+}
+
+/**
+* Requires: nothing
+* Modifies: everything
+* Effects: Unmaps the file
+*/
+void MappedFile::close() {
+#ifndef _WIN32
+  if (data) {
+    munmap(const_cast<uint8_t *>(data), size);
+  }
+#endif
+  data = nullptr;
+  size = 0;
+  bytes.clear();
+}
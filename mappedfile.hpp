@@ -0,0 +1,66 @@
+#ifndef mappedfile_hpp
+#define mappedfile_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Read only view of a whole file, mapped into memory where mmap is available
+// (otherwise read into memory), which stays valid until it is destroyed
+//  Note: on POSIX systems the view keeps the file it opened even if the file
+//  is replaced by renaming another file over it
+class MappedFile {
+public:
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Creates a view without a file
+  */
+  MappedFile();
+
+  /**
+  * Requires: nothing
+  * Modifies: the mapping
+  * Effects: Unmaps the file
+  */
+  ~MappedFile();
+
+  // Views can't be copied, since they own the mapping
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+  * Requires: a valid path to an existing file
+  * Modifies: everything
+  * Effects: Maps the file (dropping the file that was mapped before), returns
+  * if it could be mapped (empty files can't be)
+  */
+  bool open(const string &filename);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the bytes of the file (or nullptr if there isn't one), or
+  * the number of them
+  */
+  const uint8_t *getData() const;
+  size_t getSize() const;
+
+private:
+  // Store the mapped bytes, or the bytes that were read when there is no mmap
+  const uint8_t *data;
+  size_t size;
+  vector<uint8_t> bytes;
+
+  /**
+  * Requires: nothing
+  * Modifies: everything
+  * Effects: Unmaps the file
+  */
+  void close();
+};
+
+#endif
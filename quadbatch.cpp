@@ -0,0 +1,259 @@
+#include "quadbatch.hpp"
+#include "gui.hpp"
+
+/**
+* Requires: a positive size
+* Modifies: nothing
+* Effects: Returns the smallest power of two that is at least the size
+*/
+static int roundUpToPowerOfTwo(int size) {
+  int power = 1;
+  while (power < size) {
+    power *= 2;
+  }
+  return power;
+}
+
+/**
+* Requires: nothing
+* Modifies: everything
+* Effects: Creates an empty batch without a grid
+*/
+QuadBatch::QuadBatch() {
+  gridColumns = 0;
+  gridRows = 0;
+  cellWidth = 0;
+  cellHeight = 0;
+  firstColumn = 0;
+  isGridShown = false;
+  textureWidth = 0;
+  textureHeight = 0;
+  texture = 0;
+  isTextureResized = false;
+  isTextureSupported = true;
+  dirtyLeft = dirtyTop = dirtyRight = dirtyBottom = 0;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of rectangles in the batch
+*/
+int QuadBatch::getNumQuads() const {
+  return vertices.size() / 4;
+}
+
+/**
+* Requires: a positive width and height in pixels
+* Modifies: vertices and the grid
+* Effects: Removes every rectangle and stops drawing the grid, keeping the
+* memory for the next frame (the screen itself is cleared by the owner of the
+* context)
+*/
+void QuadBatch::beginFrame(int width, int height) {
+  vertices.clear();
+  gridColumns = 0;
+  isGridShown = false;
+}
+
+/**
+* Requires: a positive width and height in pixels
+* Modifies: vertices
+* Effects: Removes every rectangle, so only the ones added next are drawn over
+* what is on the screen
+*/
+void QuadBatch::beginUpdate(int width, int height) {
+  vertices.clear();
+  isGridShown = false;
+}
+
+/**
+* Requires: a valid color, the pixel x and y coordinates of the top left
+* corner, and the width and height of the rectangle
+* Modifies: vertices
+* Effects: Adds the rectangle to the batch
+*/
+void QuadBatch::fillRect(Color c, int pixelX, int pixelY, int width, int height) {
+  uint32_t rgba = packColor(c);
+  uint8_t r = rgba & 0xFF;
+  uint8_t g = (rgba >> 8) & 0xFF;
+  uint8_t b = (rgba >> 16) & 0xFF;
+
+  // Add the corners in the same order Block::draw() does
+  vertices.push_back({pixelX, pixelY, r, g, b, 255});
+  vertices.push_back({pixelX + width, pixelY, r, g, b, 255});
+  vertices.push_back({pixelX + width, pixelY + height, r, g, b, 255});
+  vertices.push_back({pixelX, pixelY + height, r, g, b, 255});
+}
+
+/**
+* Requires: positive numbers of columns and rows, and the positive width and
+* height of each cell in pixels
+* Modifies: vertices, texels, and the grid
+* Effects: Starts a new frame that shows the grid from the first column on,
+* with every cell black
+*/
+void QuadBatch::beginGrid(int numColumns, int numRows, int w, int h, int first) {
+  gridColumns = max(1, numColumns);
+  gridRows = max(1, numRows);
+  cellWidth = w;
+  cellHeight = h;
+
+  // Only create the texture again if the grid no longer fits it
+  int width = roundUpToPowerOfTwo(gridColumns);
+  int height = roundUpToPowerOfTwo(gridRows);
+  isTextureResized = isTextureResized || width != textureWidth || height != textureHeight;
+  textureWidth = width;
+  textureHeight = height;
+  texels.assign(static_cast<size_t>(textureWidth) * textureHeight, packColor({0, 0, 0}));
+  dirtyLeft = 0;
+  dirtyTop = 0;
+  dirtyRight = textureWidth;
+  dirtyBottom = textureHeight;
+
+  scrollGrid(first);
+}
+
+/**
+* Requires: a grid that was started
+* Modifies: vertices and the grid
+* Effects: Starts a new frame that shows the grid from the first column on,
+* keeping the cells of the columns that were shown before (the cells of the
+* columns that came into view have to be set)
+*/
+void QuadBatch::scrollGrid(int first) {
+  vertices.clear();
+  firstColumn = first;
+  isGridShown = true;
+}
+
+/**
+* Requires: a grid that was started, a column that is shown, a row of the
+* grid, and a valid color
+* Modifies: texels and vertices
+* Effects: Sets the color of the cell, which is kept for later frames (and
+* adds it to the batch, if the frame is drawn over the last one)
+*/
+void QuadBatch::setCell(int column, int row, Color c) {
+  int slot = getSlot(column);
+  texels[static_cast<size_t>(row) * textureWidth + slot] = packColor(c);
+  if (dirtyLeft >= dirtyRight) {
+    dirtyLeft = slot;
+    dirtyTop = row;
+    dirtyRight = slot + 1;
+    dirtyBottom = row + 1;
+  } else {
+    dirtyLeft = min(dirtyLeft, slot);
+    dirtyTop = min(dirtyTop, row);
+    dirtyRight = max(dirtyRight, slot + 1);
+    dirtyBottom = max(dirtyBottom, row + 1);
+  }
+
+  // The grid isn't drawn over the last frame, so draw just the cell
+  if (!isGridShown) {
+    fillRect(c, (column - firstColumn) * cellWidth, row * cellHeight, cellWidth, cellHeight);
+  }
+}
+
+/**
+* Requires: a current OpenGL context
+* Modifies: the texture
+* Effects: Uploads the cells that changed, draws the grid if the frame shows
+* all of it, then draws every rectangle in the batch with one draw call
+*/
+void QuadBatch::endFrame() {
+  if (gridColumns > 0) {
+    // Create the texture the first time, or once it has a new size
+    if (texture == 0 || isTextureResized) {
+      GLint maxSize = 0;
+      glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+      isTextureSupported = textureWidth <= maxSize && textureHeight <= maxSize;
+    }
+    if (!isTextureSupported) {
+      // Draw every cell shown as a rectangle under the rest of the batch
+      if (isGridShown) {
+        vector<Vertex> batch;
+        batch.swap(vertices);
+        for (int column = 0; column < gridColumns; column++) {
+          for (int row = 0; row < gridRows; row++) {
+            uint32_t rgba = texels[static_cast<size_t>(row) * textureWidth + getSlot(firstColumn + column)];
+            fillRect({(rgba & 0xFF) / 255.0, ((rgba >> 8) & 0xFF) / 255.0, ((rgba >> 16) & 0xFF) / 255.0}, column * cellWidth, row * cellHeight, cellWidth, cellHeight);
+          }
+        }
+        vertices.insert(vertices.end(), batch.begin(), batch.end());
+      }
+      isTextureResized = false;
+      dirtyRight = dirtyLeft;
+    } else if (texture == 0 || isTextureResized) {
+      if (texture == 0) {
+        glGenTextures(1, &texture);
+      }
+      glBindTexture(GL_TEXTURE_2D, texture);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+      isTextureResized = false;
+      dirtyRight = dirtyLeft;
+    }
+
+    // Upload the rectangle of texels that changed (the packed colors are in
+    // RGBA byte order on little endian machines)
+    if (isTextureSupported && dirtyLeft < dirtyRight) {
+      glBindTexture(GL_TEXTURE_2D, texture);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, textureWidth);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyLeft, dirtyTop, dirtyRight - dirtyLeft, dirtyBottom - dirtyTop, GL_RGBA, GL_UNSIGNED_BYTE, &texels[static_cast<size_t>(dirtyTop) * textureWidth + dirtyLeft]);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      dirtyRight = dirtyLeft;
+    }
+
+    // Stretch the texture over the frame, starting at the first column's
+    // slot and repeating past the end of the ring
+    if (isTextureSupported && isGridShown) {
+      glBindTexture(GL_TEXTURE_2D, texture);
+      double left = getSlot(firstColumn) / (double)textureWidth;
+      double right = left + gridColumns / (double)textureWidth;
+      double bottom = gridRows / (double)textureHeight;
+      int width = gridColumns * cellWidth;
+      int height = gridRows * cellHeight;
+      glEnable(GL_TEXTURE_2D);
+      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+      glBegin(GL_QUADS);
+      glTexCoord2d(left, 0);
+      glVertex2i(0, 0);
+      glTexCoord2d(right, 0);
+      glVertex2i(width, 0);
+      glTexCoord2d(right, bottom);
+      glVertex2i(width, height);
+      glTexCoord2d(left, bottom);
+      glVertex2i(0, height);
+      glEnd();
+      glDisable(GL_TEXTURE_2D);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  if (vertices.empty()) {
+    return;
+  }
+
+  // Point the vertex arrays into the interleaved corners, and draw them
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(2, GL_INT, sizeof(Vertex), &vertices[0].x);
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices[0].r);
+  glDrawArrays(GL_QUADS, 0, vertices.size());
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/**
+* Requires: a column of the grid
+* Modifies: nothing
+* Effects: Returns the column of texels the column of the grid is in
+*/
+int QuadBatch::getSlot(int column) const {
+  return column & (textureWidth - 1);
+}
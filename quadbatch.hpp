@@ -0,0 +1,142 @@
+#ifndef quadbatch_hpp
+#define quadbatch_hpp
+
+#include "renderbackend.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Collects colored rectangles into one interleaved array of positions and
+// colors, so a whole frame is submitted to OpenGL in a single draw call
+// instead of a glBegin()/glEnd() pair per block
+//  Note: only uses client-side vertex arrays (OpenGL 1.1), so it runs on any
+//  context, including Mesa's software rasterizer. The grid is a texture with
+//  one texel per cell, drawn stretched over the whole frame, whose columns are
+//  a ring (each column of the grid is always in the same column of texels),
+//  so scrolling uploads only the columns that came into view.
+class QuadBatch : public RenderBackend {
+public:
+  /**
+  * Requires: nothing
+  * Modifies: everything
+  * Effects: Creates an empty batch without a grid
+  */
+  QuadBatch();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of rectangles in the batch
+  */
+  int getNumQuads() const;
+
+  /**
+  * Requires: a positive width and height in pixels
+  * Modifies: vertices and the grid
+  * Effects: Removes every rectangle and stops drawing the grid, keeping the
+  * memory for the next frame (the screen itself is cleared by the owner of
+  * the context)
+  */
+  void beginFrame(int width, int height) override;
+
+  /**
+  * Requires: a positive width and height in pixels
+  * Modifies: vertices
+  * Effects: Removes every rectangle, so only the ones added next are drawn
+  * over what is on the screen
+  */
+  void beginUpdate(int width, int height) override;
+
+  /**
+  * Requires: a valid color, the pixel x and y coordinates of the top left
+  * corner, and the width and height of the rectangle
+  * Modifies: vertices
+  * Effects: Adds the rectangle to the batch
+  */
+  void fillRect(Color c, int pixelX, int pixelY, int width, int height) override;
+
+  /**
+  * Requires: positive numbers of columns and rows, and the positive width and
+  * height of each cell in pixels
+  * Modifies: vertices, texels, and the grid
+  * Effects: Starts a new frame that shows the grid from the first column on,
+  * with every cell black
+  */
+  void beginGrid(int numColumns, int numRows, int cellWidth, int cellHeight, int firstColumn) override;
+
+  /**
+  * Requires: a grid that was started
+  * Modifies: vertices and the grid
+  * Effects: Starts a new frame that shows the grid from the first column on,
+  * keeping the cells of the columns that were shown before (the cells of the
+  * columns that came into view have to be set)
+  */
+  void scrollGrid(int firstColumn) override;
+
+  /**
+  * Requires: a grid that was started, a column that is shown, a row of the
+  * grid, and a valid color
+  * Modifies: texels and vertices
+  * Effects: Sets the color of the cell, which is kept for later frames (and
+  * adds it to the batch, if the frame is drawn over the last one)
+  */
+  void setCell(int column, int row, Color c) override;
+
+  /**
+  * Requires: a current OpenGL context
+  * Modifies: the texture
+  * Effects: Uploads the cells that changed, draws the grid if the frame shows
+  * all of it, then draws every rectangle in the batch with one draw call
+  */
+  void endFrame() override;
+
+private:
+  // One corner of a rectangle, laid out the way the vertex arrays read it
+  struct Vertex {
+    int32_t x;
+    int32_t y;
+    uint8_t r, g, b, a;
+  };
+
+  // Store four corners for each rectangle
+  vector<Vertex> vertices;
+
+  // Store the size of the grid and its cells, the column on the left of the
+  // frame, and if the frame shows the whole grid (instead of drawing over the
+  // last frame)
+  int gridColumns;
+  int gridRows;
+  int cellWidth;
+  int cellHeight;
+  int firstColumn;
+  bool isGridShown;
+
+  // Store a copy of the texture, whose sides are the powers of two that fit
+  // the grid (so the texture repeats across the ring), the name of the
+  // texture (0 until it is created), if it has to be created again, and if
+  // the context can hold it (otherwise the cells are drawn as rectangles)
+  //  Note: the texture isn't deleted, since the context may be gone first
+  vector<uint32_t> texels;
+  int textureWidth;
+  int textureHeight;
+  unsigned int texture;
+  bool isTextureResized;
+  bool isTextureSupported;
+
+  // Store the texels that changed since they were uploaded (right and bottom
+  // are past the last one)
+  int dirtyLeft;
+  int dirtyTop;
+  int dirtyRight;
+  int dirtyBottom;
+
+  /**
+  * Requires: a column of the grid
+  * Modifies: nothing
+  * Effects: Returns the column of texels the column of the grid is in
+  */
+  int getSlot(int column) const;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "renderbackend.hpp"
+#include <algorithm>
+
+/**
+* Requires: a valid color
+* Modifies: nothing
+* Effects: Returns the color as 8 bit red, green, blue, and alpha channels,
+* packed from the lowest byte up
+*/
+uint32_t packColor(Color c) {
+  // Round each channel to the closest byte
+  auto channel = [](double value) { return static_cast<uint32_t>(max(0.0, min(value, 1.0)) * 255 + 0.5); };
+  return channel(c.r) | channel(c.g) << 8 | channel(c.b) << 16 | 0xFFU << 24;
+}
@@ -0,0 +1,85 @@
+#ifndef renderbackend_hpp
+#define renderbackend_hpp
+
+#include "block.hpp"
+#include <cstdint>
+
+using namespace std;
+
+// Something the board can be drawn on, one frame at a time
+//  Note: OpenGL (QuadBatch) and a CPU framebuffer (FrameBuffer) implement it,
+//  so the board can be drawn without a window. Besides filling rectangles, a
+//  backend keeps a grid of cells in a ring of columns between frames, so
+//  scrolling by a column only sets the cells of the column that came into
+//  view.
+class RenderBackend {
+public:
+  virtual ~RenderBackend() {
+  }
+
+  /**
+  * Requires: a positive width and height in pixels
+  * Modifies: the frame
+  * Effects: Starts a new frame of the size, which begins black
+  */
+  virtual void beginFrame(int width, int height) = 0;
+
+  /**
+  * Requires: a positive width and height in pixels
+  * Modifies: the frame
+  * Effects: Starts drawing over the last frame, keeping what is already there
+  * (a frame of a different size is started over)
+  */
+  virtual void beginUpdate(int width, int height) = 0;
+
+  /**
+  * Requires: a valid color, the pixel x and y coordinates of the top left
+  * corner, and the width and height of the rectangle
+  * Modifies: the frame
+  * Effects: Fills the rectangle with the color (over what is already there)
+  */
+  virtual void fillRect(Color c, int pixelX, int pixelY, int width, int height) = 0;
+
+  /**
+  * Requires: positive numbers of columns and rows, and the positive width and
+  * height of each cell in pixels
+  * Modifies: the frame and the grid
+  * Effects: Starts a new frame that shows the grid from the first column on,
+  * with every cell black (the frame is the size of the cells shown)
+  */
+  virtual void beginGrid(int numColumns, int numRows, int cellWidth, int cellHeight, int firstColumn) = 0;
+
+  /**
+  * Requires: a grid that was started
+  * Modifies: the frame and the grid
+  * Effects: Starts a new frame that shows the grid from the first column on,
+  * keeping the cells of the columns that were shown before (the cells of the
+  * columns that came into view have to be set)
+  */
+  virtual void scrollGrid(int firstColumn) = 0;
+
+  /**
+  * Requires: a grid that was started, a column that is shown, a row of the
+  * grid, and a valid color
+  * Modifies: the frame and the grid
+  * Effects: Sets the color of the cell, which is kept for later frames
+  */
+  virtual void setCell(int column, int row, Color c) = 0;
+
+  /**
+  * Requires: a frame that was started
+  * Modifies: the frame
+  * Effects: Finishes the frame, drawing anything that is still waiting
+  */
+  virtual void endFrame() = 0;
+};
+
+/**
+* Requires: a valid color
+* Modifies: nothing
+* Effects: Returns the color as 8 bit red, green, blue, and alpha channels,
+* packed from the lowest byte up
+*/
+uint32_t packColor(Color c);
+
+#endif
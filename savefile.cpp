@@ -0,0 +1,774 @@
+#include "savefile.hpp"
+#include "compression.hpp"
+#include "jsonsavereader.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <experimental/filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+// Bytes every binary save starts with
+static const char BINARY_SAVE_MAGIC[8] = {'I', 'N', 'F', 'I', 'N', 'I', 'T', 'Y'};
+
+// Flags of a binary save
+static const uint64_t COMPRESSED_SAVE_FLAG = 1;
+
+// *** Encoding ***
+
+/**
+* Requires: a buffer and a value
+* Modifies: bytes
+* Effects: Appends the value to the buffer in little endian order
+*/
+void putU32(vector<uint8_t> &bytes, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+void putU64(vector<uint8_t> &bytes, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+void putDouble(vector<uint8_t> &bytes, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putU64(bytes, bits);
+}
+void putColor(vector<uint8_t> &bytes, Color c) {
+  putDouble(bytes, c.r);
+  putDouble(bytes, c.g);
+  putDouble(bytes, c.b);
+}
+
+/**
+* Requires: a buffer and a value
+* Modifies: bytes
+* Effects: Appends the value to the buffer as a varint (7 bits per byte, with
+* the high bit set on every byte but the last)
+*/
+void putVarint(vector<uint8_t> &bytes, uint64_t value) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+// *** Save files ***
+
+/**
+* Requires: a filename
+* Modifies: nothing
+* Effects: Returns if the filename ends with the extension
+*/
+bool hasSaveExtension(const string &filename, const string &extension) {
+  return filename.size() >= extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+* Requires: a filename
+* Modifies: nothing
+* Effects: Returns if the file starts with the binary save header
+*/
+bool isBinarySave(const string &filename) {
+  char magic[sizeof(BINARY_SAVE_MAGIC)];
+  ifstream file(filename, ios::binary);
+  return file.read(magic, sizeof(magic)) && memcmp(magic, BINARY_SAVE_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Returns the number of changes, loaded or not
+*/
+uint64_t countChanges(const SaveData &data) {
+  uint64_t numChanges = data.changes.size();
+  for (const SaveChunk &chunk : data.unloadedChunks) {
+    numChanges += chunk.numChanges;
+  }
+  return numChanges;
+}
+
+/**
+* Requires: save data
+* Modifies: data.changes
+* Effects: Drops the changes that are the same as the tile the save's
+* generator places there (like a wall that was removed and added again), so
+* the save only has what differs from the seed, returns the number dropped
+*  Note: chunks that aren't loaded are left as they are
+*/
+int normalizeChanges(SaveData &data) {
+  // Use the save's own generator, starting legacy streams from its checkpoints
+  Generator generator(data.seed, data.percentWall, data.gameVersion);
+  generator.setCheckpoints(data.checkpoints, data.numBlocksHigh);
+
+  // Generate each changed column once, in order, and compare its changes
+  int numDropped = 0;
+  int generatedColumn = -1;
+  vector<uint64_t> wallBits;
+  for (uint64_t key : data.changes.getSortedKeys()) {
+    int column = ChangeMap::unpackColumn(key);
+    int row = ChangeMap::unpackRow(key);
+    if (row >= data.numBlocksHigh) {
+      continue;
+    }
+    if (column != generatedColumn) {
+      generator.generateColumn(column, data.numBlocksHigh, wallBits);
+      generatedColumn = column;
+    }
+    Tile generated = (wallBits[row / 64] & (1ULL << (row % 64))) ? WALL_TILE : GRASS_TILE;
+    if (data.changes.getChange(column, row) == generated) {
+      data.changes.removeChange(column, row);
+      numDropped++;
+    }
+  }
+
+  return numDropped;
+}
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Encodes the header of the binary save layout, which is also the
+* layout of a summary file
+*/
+vector<uint8_t> encodeSaveSummary(const SaveData &data) {
+  vector<uint8_t> bytes(BINARY_SAVE_MAGIC, BINARY_SAVE_MAGIC + sizeof(BINARY_SAVE_MAGIC));
+
+  // Add the header
+  putU32(bytes, BINARY_SAVE_VERSION);
+  putU32(bytes, data.gameVersion);
+  putU64(bytes, data.saveTime);
+  putU32(bytes, data.numBlocksWide);
+  putU32(bytes, data.numBlocksHigh);
+  putU32(bytes, data.blockWidth);
+  putU32(bytes, data.blockHeight);
+  putU32(bytes, data.leftDisplayEdge);
+  putU32(bytes, data.seed);
+  putDouble(bytes, data.percentWall);
+
+  // Add the player
+  putColor(bytes, data.player.getColor());
+  putColor(bytes, data.player.getAlternateColor());
+  putU32(bytes, data.player.getVectorX());
+  putU32(bytes, data.player.getVectorY());
+
+  // Add the number of changes, so the summary doesn't depend on the body
+  putU64(bytes, countChanges(data));
+
+  return bytes;
+}
+
+/**
+* Requires: the changes in a chunk, sorted by column then row
+* Modifies: bytes
+* Effects: Appends the chunk in the binary save layout, with the colors it
+* uses
+*/
+static void encodeChunk(vector<uint8_t> &bytes, const ChangeMap &changes, const uint64_t *keys, size_t numKeys, int firstColumn) {
+  // Add the colors used by the changes, numbered in the order they are first
+  // used, so the file doesn't depend on the order of the palette in memory
+  int fileIndices[TILE_PALETTE_SIZE];
+  fill(fileIndices, fileIndices + TILE_PALETTE_SIZE, -1);
+  vector<uint8_t> fileColors;
+  for (size_t i = 0; i < numKeys; i++) {
+    uint8_t colorIndex = changes.getChange(ChangeMap::unpackColumn(keys[i]), ChangeMap::unpackRow(keys[i])).colorIndex;
+    if (fileIndices[colorIndex] == -1) {
+      fileIndices[colorIndex] = fileColors.size();
+      fileColors.push_back(colorIndex);
+    }
+  }
+  putVarint(bytes, fileColors.size());
+  for (uint8_t colorIndex : fileColors) {
+    putColor(bytes, getPaletteColor(colorIndex));
+  }
+
+  // Add the changes, storing the distance from the previous change so nearby
+  // edits take a byte or two
+  int lastColumn = firstColumn;
+  int lastRow = -1;
+  for (size_t i = 0; i < numKeys; i++) {
+    int column = ChangeMap::unpackColumn(keys[i]);
+    int row = ChangeMap::unpackRow(keys[i]);
+    Tile tile = changes.getChange(column, row);
+
+    // Rows restart from the top of every new column
+    putVarint(bytes, column - lastColumn);
+    putVarint(bytes, (column == lastColumn && i > 0) ? row - lastRow - 1 : row);
+    bytes.push_back(static_cast<uint8_t>(tile.blockType | (tile.floorType << 4)));
+    putVarint(bytes, fileIndices[tile.colorIndex]);
+
+    lastColumn = column;
+    lastRow = row;
+  }
+}
+
+/**
+* Requires: save data, whose unloaded chunks don't have any changes in the
+* changes map
+* Modifies: nothing
+* Effects: Encodes the save data in the binary save layout
+*/
+vector<uint8_t> encodeBinarySave(const SaveData &data) {
+  vector<uint8_t> bytes = encodeSaveSummary(data);
+
+  // Add the checkpoints of the stream, in order
+  putVarint(bytes, data.checkpoints.size());
+  int lastColumn = 0;
+  for (const StreamCheckpoint &checkpoint : data.checkpoints) {
+    putVarint(bytes, checkpoint.column - lastColumn);
+    putVarint(bytes, checkpoint.state.size());
+    for (uint32_t word : checkpoint.state) {
+      putU32(bytes, word);
+    }
+    lastColumn = checkpoint.column;
+  }
+
+  // Encode each chunk of columns on its own, so it can be loaded without the
+  // others, copying the chunks that were never loaded from their file as they
+  // are
+  vector<uint64_t> keys = data.changes.getSortedKeys();
+  vector<SaveChunk> chunks;
+  vector<uint8_t> body;
+  size_t nextKey = 0;
+  size_t nextUnloaded = 0;
+  while (nextKey < keys.size() || nextUnloaded < data.unloadedChunks.size()) {
+    int keyChunk = nextKey < keys.size() ? ChangeMap::unpackColumn(keys[nextKey]) / SAVE_CHUNK_WIDTH : INT_MAX;
+    if (nextUnloaded < data.unloadedChunks.size() && data.unloadedChunks[nextUnloaded].chunk < keyChunk) {
+      const SaveChunk &chunk = data.unloadedChunks[nextUnloaded++];
+      const uint8_t *chunkBytes = data.file->getData() + chunk.offset;
+      chunks.push_back({chunk.chunk, chunk.numChanges, body.size(), chunk.size, chunk.rawSize});
+      body.insert(body.end(), chunkBytes, chunkBytes + chunk.size);
+    } else {
+      size_t firstKey = nextKey;
+      while (nextKey < keys.size() && ChangeMap::unpackColumn(keys[nextKey]) / SAVE_CHUNK_WIDTH == keyChunk) {
+        nextKey++;
+      }
+      size_t offset = body.size();
+      encodeChunk(body, data.changes, keys.data() + firstKey, nextKey - firstKey, keyChunk * SAVE_CHUNK_WIDTH);
+      size_t rawSize = 0;
+
+      // Compress the chunk, unless that doesn't make it smaller
+      if (data.isCompressed) {
+        vector<uint8_t> compressed;
+        compressBlock(body.data() + offset, body.size() - offset, compressed);
+        if (compressed.size() < body.size() - offset) {
+          rawSize = body.size() - offset;
+          body.resize(offset);
+          body.insert(body.end(), compressed.begin(), compressed.end());
+        }
+      }
+      chunks.push_back({keyChunk, static_cast<int>(nextKey - firstKey), offset, body.size() - offset, rawSize});
+    }
+  }
+
+  // Add the flags, the index of the chunks, then the chunks
+  putVarint(bytes, data.isCompressed ? COMPRESSED_SAVE_FLAG : 0);
+  putVarint(bytes, chunks.size());
+  int lastChunk = 0;
+  for (const SaveChunk &chunk : chunks) {
+    putVarint(bytes, chunk.chunk - lastChunk);
+    putVarint(bytes, chunk.numChanges);
+    putVarint(bytes, chunk.size);
+    putVarint(bytes, chunk.rawSize);
+    lastChunk = chunk.chunk;
+  }
+  bytes.insert(bytes.end(), body.begin(), body.end());
+
+  return bytes;
+}
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Encodes the save data as pretty printed JSON
+*/
+string encodeJsonSave(const SaveData &data) {
+  // Create new json object
+  json gameJson;
+
+  // Add game version
+  gameJson["gameVersion"] = data.gameVersion;
+
+  // Add time saved
+  gameJson["saveTime"] = data.saveTime;
+
+  // Add the game dimensions
+  gameJson["numBlocksWide"] = data.numBlocksWide;
+  gameJson["numBlocksHigh"] = data.numBlocksHigh;
+  gameJson["blockWidth"] = data.blockWidth;
+  gameJson["blockHeight"] = data.blockHeight;
+
+  // Save the left display edge
+  gameJson["leftDisplayEdge"] = data.leftDisplayEdge;
+
+  // Add the seed
+  gameJson["seed"] = data.seed;
+
+  // Add the percentages
+  gameJson["percentWall"] = data.percentWall;
+
+  // Add the player
+  gameJson["player"] = data.player.toJson();
+
+  // Add the changes, sorted by position, loading the chunks that are still in
+  // their file
+  const ChangeMap *changes = &data.changes;
+  ChangeMap allChanges;
+  if (!data.unloadedChunks.empty()) {
+    allChanges = data.changes;
+    for (const SaveChunk &chunk : data.unloadedChunks) {
+      decodeSaveChunk(*data.file, chunk, allChanges);
+    }
+    changes = &allChanges;
+  }
+  for (uint64_t key : changes->getSortedKeys()) {
+    int column = ChangeMap::unpackColumn(key);
+    int row = ChangeMap::unpackRow(key);
+    json object = blockFromTile(changes->getChange(column, row))->toJson(); // Convert the block to JSON (without the shared blocks, so saves can be encoded on any thread)
+    object["column"] = column;                                                  // Add the column position
+    object["row"] = row;                                                        // Add the row position
+    gameJson["changes"].push_back(object);                                      // Add to the changes json array
+  }
+
+  // Add the checkpoints of the stream
+  for (const StreamCheckpoint &checkpoint : data.checkpoints) {
+    gameJson["streamCheckpoints"].push_back({{"column", checkpoint.column}, {"state", checkpoint.state}});
+  }
+
+  // Pretty print
+  ostringstream text;
+  text << setw(4) << gameJson << endl;
+  return text.str();
+}
+
+/**
+* Requires: a valid path to save the file to, and the contents of the file
+* Modifies: the file
+* Effects: Writes the contents to a temporary file next to the file, then
+* renames it over the file, so the file is never partly written, returns save
+* status
+*/
+bool writeFileAtomically(const string &filename, const void *contents, size_t size) {
+  // Write the temporary file
+  string temporaryFilename = filename + ".tmp";
+  ofstream file(temporaryFilename, ios::binary | ios::trunc);
+  if (!file || !file.write(static_cast<const char *>(contents), size).flush()) {
+    file.close();
+    remove(temporaryFilename.c_str());
+    return false;
+  }
+  file.close();
+
+  // Replace the file (Windows won't rename over an existing file)
+#ifdef _WIN32
+  remove(filename.c_str());
+#endif
+  if (rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+    remove(temporaryFilename.c_str());
+    return false;
+  }
+  return true;
+}
+
+/**
+* Requires: a valid path to save the file to, and save data
+* Modifies: the file
+* Effects: Writes the save data to the file in the binary save layout (or as
+* JSON), returns save status
+*/
+bool writeBinarySave(const string &filename, const SaveData &data) {
+  vector<uint8_t> bytes = encodeBinarySave(data);
+  return writeFileAtomically(filename, bytes.data(), bytes.size());
+}
+
+/**
+* Requires: a valid path to save the file to, and save data
+* Modifies: the file and its summary file
+* Effects: Writes the save data to the file as JSON, and its summary next to
+* it (since the summary can't be read from JSON without reading the whole
+* file), returns save status
+*/
+bool writeJsonSave(const string &filename, const SaveData &data) {
+  string text = encodeJsonSave(data);
+  if (!writeFileAtomically(filename, text.data(), text.size())) {
+    return false;
+  }
+
+  // Write the summary after the save, so it is never older than the save
+  // unless the save was changed by something else
+  vector<uint8_t> summary = encodeSaveSummary(data);
+  writeFileAtomically(filename + SAVE_SUMMARY_EXTENSION, summary.data(), summary.size());
+  return true;
+}
+
+/**
+* Requires: a valid path to save the file to, and save data
+* Modifies: the file
+* Effects: Writes the save data to the file as JSON if it ends with
+* JSON_SAVE_EXTENSION, otherwise in the binary layout, returns save status
+*/
+bool writeSave(const string &filename, const SaveData &data) {
+  return hasSaveExtension(filename, JSON_SAVE_EXTENSION) ? writeJsonSave(filename, data) : writeBinarySave(filename, data);
+}
+
+/**
+* Requires: a reader at the colors of a chunk (or of the whole save in older
+* layouts)
+* Modifies: reader and paletteIndices
+* Effects: Reads the colors, and finds them in the palette, returns if they
+* were valid
+*/
+static bool decodeColors(ByteReader &reader, vector<uint8_t> &paletteIndices) {
+  uint64_t numColors = reader.getVarint();
+  if (numColors > TILE_PALETTE_SIZE) {
+    return false;
+  }
+  paletteIndices.clear();
+  for (uint64_t i = 0; i < numColors && reader.isValid; i++) {
+    paletteIndices.push_back(getPaletteIndex(reader.getColor()));
+  }
+  return reader.isValid;
+}
+
+/**
+* Requires: a reader at the changes of a chunk (or of the whole save in older
+* layouts), and the palette indices of its colors
+* Modifies: reader and changes
+* Effects: Reads the changes straight into the map, keeping the changes that
+* are already in it if they are newer, returns if they were valid and from
+* the first column up to (but not including) the last column
+*/
+static bool decodeChanges(ByteReader &reader, uint64_t numChanges, const vector<uint8_t> &paletteIndices, uint64_t firstColumn, uint64_t lastColumn, ChangeMap &changes, bool isOlder) {
+  if (!reader.isValid || numChanges > static_cast<uint64_t>(reader.end - reader.next)) {
+    return false;
+  }
+  uint64_t column = firstColumn;
+  uint64_t row = 0;
+  for (uint64_t i = 0; i < numChanges && reader.isValid; i++) {
+    uint64_t columnDelta = reader.getVarint();
+    uint64_t rowValue = reader.getVarint();
+    uint8_t type = reader.getByte();
+    uint64_t colorIndex = reader.getVarint();
+
+    // Rows restart from the top of every new column
+    row = (i == 0 || columnDelta > 0) ? rowValue : row + rowValue + 1;
+    column += columnDelta;
+
+    // Make sure the change is on the board and is a wall or floor
+    Tile tile = {static_cast<uint8_t>(type & 0xF), static_cast<uint8_t>(type >> 4), 0};
+    if (column >= lastColumn || row > INT_MAX || colorIndex >= paletteIndices.size() || (tile.blockType != WallBlock && tile.blockType != FloorBlock)) {
+      return false;
+    }
+    tile.colorIndex = paletteIndices[colorIndex];
+    if (!isOlder || !changes.hasChange(column, row)) {
+      changes.setChange(column, row, tile);
+    }
+  }
+  return reader.isValid;
+}
+
+/**
+* Requires: bytes in the binary save layout, and a chunk in them
+* Modifies: changes
+* Effects: Decodes the chunk's changes into the map, returns if they were
+* valid
+*/
+static bool decodeChunk(const uint8_t *bytes, size_t size, const SaveChunk &chunk, ChangeMap &changes, bool isOlder) {
+  if (chunk.offset > size || chunk.size > size - chunk.offset) {
+    return false;
+  }
+  ByteReader reader = {bytes + chunk.offset, bytes + chunk.offset + chunk.size, true};
+
+  // Decompress the chunk first if it is compressed
+  vector<uint8_t> raw;
+  if (chunk.rawSize > 0) {
+    raw.resize(chunk.rawSize);
+    if (!decompressBlock(reader.next, chunk.size, raw.data(), raw.size())) {
+      return false;
+    }
+    reader = {raw.data(), raw.data() + raw.size(), true};
+  }
+
+  vector<uint8_t> paletteIndices;
+  uint64_t firstColumn = static_cast<uint64_t>(chunk.chunk) * SAVE_CHUNK_WIDTH;
+  return decodeColors(reader, paletteIndices) && decodeChanges(reader, chunk.numChanges, paletteIndices, firstColumn, firstColumn + SAVE_CHUNK_WIDTH, changes, isOlder);
+}
+
+/**
+* Requires: bytes in the binary save layout
+* Modifies: data
+* Effects: Decodes the save data from the bytes, leaving the chunks of
+* changes in data.unloadedChunks if it is lazy (older layouts are always
+* decoded in full), returns if they were valid
+*/
+static bool decodeSave(const uint8_t *bytes, size_t size, SaveData &data, bool isLazy) {
+  // Check the header
+  if (size < sizeof(BINARY_SAVE_MAGIC) || memcmp(bytes, BINARY_SAVE_MAGIC, sizeof(BINARY_SAVE_MAGIC)) != 0) {
+    return false;
+  }
+  ByteReader reader = {bytes + sizeof(BINARY_SAVE_MAGIC), bytes + size, true};
+  uint32_t saveVersion = reader.getU32();
+  if (saveVersion < 1 || saveVersion > BINARY_SAVE_VERSION) {
+    return false;
+  }
+
+  // Read the header
+  data.gameVersion = reader.getU32();
+  data.saveTime = reader.getU64();
+  data.numBlocksWide = reader.getU32();
+  data.numBlocksHigh = reader.getU32();
+  data.blockWidth = reader.getU32();
+  data.blockHeight = reader.getU32();
+  data.leftDisplayEdge = reader.getU32();
+  data.seed = reader.getU32();
+  data.percentWall = reader.getDouble();
+
+  // Read the player
+  data.player.setColor(reader.getColor());
+  data.player.setAlternateColor(reader.getColor());
+  data.player.setVectorX(reader.getU32());
+  data.player.setVectorY(reader.getU32());
+
+  // Read the number of changes, which is after the colors in older layouts
+  uint64_t numChanges = saveVersion >= 3 ? reader.getU64() : 0;
+
+  data.changes.clear();
+  data.checkpoints.clear();
+  data.unloadedChunks.clear();
+  data.file.reset();
+  data.isCompressed = false;
+
+  // Read the checkpoints of the stream, which are after the changes in older
+  // layouts (and missing from the first one)
+  auto decodeCheckpoints = [&reader, &data]() {
+    uint64_t numCheckpoints = reader.getVarint();
+    if (!reader.isValid || numCheckpoints > static_cast<uint64_t>(reader.end - reader.next)) {
+      return false;
+    }
+    uint64_t column = 0;
+    for (uint64_t i = 0; i < numCheckpoints && reader.isValid; i++) {
+      column += reader.getVarint();
+      uint64_t numWords = reader.getVarint();
+      if (column > INT_MAX || !reader.has(numWords * 4)) {
+        return false;
+      }
+      StreamCheckpoint checkpoint = {static_cast<int>(column), vector<uint32_t>(numWords)};
+      for (uint32_t &word : checkpoint.state) {
+        word = reader.getU32();
+      }
+      data.checkpoints.push_back(move(checkpoint));
+    }
+    return reader.isValid;
+  };
+
+  // Older layouts have one list of changes for the whole save
+  if (saveVersion < 4) {
+    vector<uint8_t> paletteIndices;
+    if (!decodeColors(reader, paletteIndices)) {
+      return false;
+    }
+    if (saveVersion < 3) {
+      numChanges = reader.getVarint();
+    }
+    if (!decodeChanges(reader, numChanges, paletteIndices, 0, static_cast<uint64_t>(INT_MAX) + 1, data.changes, false)) {
+      return false;
+    }
+    return saveVersion < 2 || decodeCheckpoints();
+  }
+
+  // Read the flags (which older layouts don't have), then the index of the
+  // chunks, which follow it in order
+  if (!decodeCheckpoints()) {
+    return false;
+  }
+  if (saveVersion >= 5) {
+    data.isCompressed = reader.getVarint() & COMPRESSED_SAVE_FLAG;
+  }
+  uint64_t numChunks = reader.getVarint();
+  if (!reader.isValid || numChunks > static_cast<uint64_t>(reader.end - reader.next)) {
+    return false;
+  }
+  vector<SaveChunk> chunks;
+  uint64_t chunk = 0;
+  uint64_t numIndexed = 0;
+  for (uint64_t i = 0; i < numChunks && reader.isValid; i++) {
+    chunk += reader.getVarint();
+    uint64_t chunkChanges = reader.getVarint();
+    uint64_t chunkSize = reader.getVarint();
+    uint64_t rawSize = saveVersion >= 5 ? reader.getVarint() : 0;
+    if (chunk > INT_MAX / SAVE_CHUNK_WIDTH || chunkChanges > (rawSize > 0 ? rawSize : chunkSize) || rawSize / MAX_COMPRESSION_RATIO > chunkSize || (i > 0 && chunk == static_cast<uint64_t>(chunks.back().chunk))) {
+      return false;
+    }
+    chunks.push_back({static_cast<int>(chunk), static_cast<int>(chunkChanges), 0, static_cast<size_t>(chunkSize), static_cast<size_t>(rawSize)});
+    numIndexed += chunkChanges;
+  }
+  size_t offset = reader.next - bytes;
+  for (SaveChunk &indexed : chunks) {
+    indexed.offset = offset;
+    offset += indexed.size;
+  }
+  if (!reader.isValid || offset > size || numIndexed != numChanges) {
+    return false;
+  }
+
+  // Leave the chunks to be loaded when they are needed, or load them all
+  if (isLazy) {
+    data.unloadedChunks = move(chunks);
+    return true;
+  }
+  for (const SaveChunk &indexed : chunks) {
+    if (!decodeChunk(bytes, size, indexed, data.changes, false)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+* Requires: bytes in the binary save layout
+* Modifies: data
+* Effects: Decodes the save data from the bytes, returns if they were valid
+*/
+bool decodeBinarySave(const uint8_t *bytes, size_t size, SaveData &data) {
+  return decodeSave(bytes, size, data, false);
+}
+
+/**
+* Requires: a valid path to an existing binary save file
+* Modifies: data
+* Effects: Maps the file into memory and decodes everything but the chunks of
+* changes, which are left in data.unloadedChunks for decodeSaveChunk() with
+* data.file keeping the file mapped (older layouts are decoded in full),
+* returns load status
+*/
+bool openBinarySave(const string &filename, SaveData &data) {
+  shared_ptr<MappedFile> file = make_shared<MappedFile>();
+  if (!file->open(filename) || !decodeSave(file->getData(), file->getSize(), data, true)) {
+    return false;
+  }
+  if (!data.unloadedChunks.empty()) {
+    data.file = file;
+  }
+  return true;
+}
+
+/**
+* Requires: a chunk of the mapped save file
+* Modifies: changes
+* Effects: Decodes the chunk's changes into the map, keeping the changes that
+* are already in it (since they were made after the save), returns if they
+* were valid
+*/
+bool decodeSaveChunk(const MappedFile &file, const SaveChunk &chunk, ChangeMap &changes) {
+  return decodeChunk(file.getData(), file.getSize(), chunk, changes, true);
+}
+
+/**
+* Requires: a valid path to an existing binary save file
+* Modifies: data
+* Effects: Maps the file into memory and decodes the save data straight from
+* it, returns load status
+*/
+bool readBinarySave(const string &filename, SaveData &data) {
+  if (!openBinarySave(filename, data)) {
+    return false;
+  }
+  for (const SaveChunk &chunk : data.unloadedChunks) {
+    if (!decodeChunk(data.file->getData(), data.file->getSize(), chunk, data.changes, false)) {
+      return false;
+    }
+  }
+  data.unloadedChunks.clear();
+  data.file.reset();
+  return true;
+}
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Returns the summary of the save data
+*/
+SaveSummary summarizeSave(const SaveData &data) {
+  return {data.gameVersion, data.saveTime, data.seed, data.percentWall, data.player.getVectorX(), data.player.getVectorY(), countChanges(data)};
+}
+
+/**
+* Requires: bytes in the layout of a binary save header from version 3 on
+* Modifies: summary
+* Effects: Decodes the summary from the header, returns if it was valid
+*/
+bool decodeSaveSummary(const uint8_t *bytes, size_t size, SaveSummary &summary) {
+  // Check the header
+  if (size < SAVE_SUMMARY_SIZE || memcmp(bytes, BINARY_SAVE_MAGIC, sizeof(BINARY_SAVE_MAGIC)) != 0) {
+    return false;
+  }
+  ByteReader reader = {bytes + sizeof(BINARY_SAVE_MAGIC), bytes + SAVE_SUMMARY_SIZE, true};
+  uint32_t saveVersion = reader.getU32();
+  if (saveVersion < 3 || saveVersion > BINARY_SAVE_VERSION) {
+    return false;
+  }
+
+  // Read the fields of the summary, skipping the rest
+  summary.gameVersion = reader.getU32();
+  summary.saveTime = reader.getU64();
+  reader.next += 5 * 4; // Dimensions and left display edge
+  summary.seed = reader.getU32();
+  summary.percentWall = reader.getDouble();
+  reader.next += 2 * 3 * 8; // Player colors
+  summary.playerX = reader.getU32();
+  summary.playerY = reader.getU32();
+  summary.numChanges = reader.getU64();
+
+  return reader.isValid;
+}
+
+/**
+* Requires: a valid path to an existing save file
+* Modifies: summary
+* Effects: Reads the summary of the save from the header of a binary save, or
+* from the summary file of a JSON save, returns load status
+*  Note: saves from before the summary (or JSON saves changed after their
+*  summary) are read in full instead
+*/
+bool readSaveSummary(const string &filename, SaveSummary &summary) {
+  bool isBinary = isBinarySave(filename);
+
+  // Find where the summary would be, and make sure it is up to date
+  string summaryFilename = isBinary ? filename : filename + SAVE_SUMMARY_EXTENSION;
+  bool isCurrent = isBinary;
+  if (!isBinary) {
+    error_code error;
+    auto summaryTime = experimental::filesystem::last_write_time(summaryFilename, error);
+    isCurrent = !error && summaryTime >= experimental::filesystem::last_write_time(filename, error) && !error;
+  }
+
+  // Read just the header
+  if (isCurrent) {
+    uint8_t header[SAVE_SUMMARY_SIZE];
+    ifstream file(summaryFilename, ios::binary);
+    if (file.read(reinterpret_cast<char *>(header), sizeof(header)) && decodeSaveSummary(header, sizeof(header), summary)) {
+      return true;
+    }
+  }
+
+  // Otherwise read the whole save
+  SaveData data;
+  if (isBinary) {
+    if (!readBinarySave(filename, data)) {
+      return false;
+    }
+  } else {
+    ifstream file(filename);
+    if (!file || !JsonSaveReader(file).read(data)) {
+      return false;
+    }
+  }
+  summary = summarizeSave(data);
+  return true;
+}
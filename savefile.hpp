@@ -0,0 +1,317 @@
+#ifndef savefile_hpp
+#define savefile_hpp
+
+#include "changemap.hpp"
+#include "generator.hpp"
+#include "mappedfile.hpp"
+#include "player.hpp"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Extensions of binary and JSON save files
+const string BINARY_SAVE_EXTENSION = ".infinity.bin";
+const string JSON_SAVE_EXTENSION = ".infinity.json";
+
+// Extension added to a JSON save for the file with its summary
+const string SAVE_SUMMARY_EXTENSION = ".summary";
+
+// Version of the binary save layout (separate from the game version, which
+// selects how the board is generated)
+//  Version 2 adds the checkpoints of the version 1 stream after the changes
+//  Version 3 moves the number of changes into the header, so the whole
+//  summary of the save is in its first SAVE_SUMMARY_SIZE bytes
+//  Version 4 groups the changes into chunks of SAVE_CHUNK_WIDTH columns after
+//  an index of them, so each chunk can be loaded on its own
+//  Version 5 adds flags for the save before the index, and the decompressed
+//  size of each chunk to the index, so chunks can be compressed
+const int BINARY_SAVE_VERSION = 5;
+
+// Number of columns in each chunk of changes in a binary save
+const int SAVE_CHUNK_WIDTH = 256;
+
+// Size of the header of a binary save (and of a summary file)
+const int SAVE_SUMMARY_SIZE = 120;
+
+// Where a chunk of changes is in a binary save
+struct SaveChunk {
+  int chunk;      // Column of the chunk divided by SAVE_CHUNK_WIDTH
+  int numChanges; // Number of changes in the chunk
+  size_t offset;  // Bytes from the start of the file
+  size_t size;    // Bytes used by the chunk
+  size_t rawSize; // Bytes used by the chunk once decompressed, or 0 if it isn't compressed
+};
+
+// Everything stored in a save file
+struct SaveData {
+  int gameVersion;
+  long long saveTime;
+  int numBlocksWide;
+  int numBlocksHigh;
+  int blockWidth;
+  int blockHeight;
+  int leftDisplayEdge;
+  int seed;
+  double percentWall;
+  Player player;
+  ChangeMap changes;
+  vector<StreamCheckpoint> checkpoints;
+
+  // Chunks of changes that are only in the save they were read from (in
+  // order), and that save, which they are copied from when saving
+  vector<SaveChunk> unloadedChunks;
+  shared_ptr<const MappedFile> file;
+
+  // Compress the chunks of changes in binary saves (kept in the save, so it
+  // is compressed again when it is written again)
+  bool isCompressed = false;
+};
+
+// What the save picker shows about a save, read without reading its changes
+struct SaveSummary {
+  int gameVersion;
+  long long saveTime;
+  int seed;
+  double percentWall;
+  int playerX;
+  int playerY;
+  uint64_t numChanges;
+};
+
+// *** Encoding ***
+
+/**
+* Requires: a buffer and a value
+* Modifies: bytes
+* Effects: Appends the value to the buffer in little endian order
+*/
+void putU32(vector<uint8_t> &bytes, uint32_t value);
+void putU64(vector<uint8_t> &bytes, uint64_t value);
+void putDouble(vector<uint8_t> &bytes, double value);
+void putColor(vector<uint8_t> &bytes, Color c);
+
+/**
+* Requires: a buffer and a value
+* Modifies: bytes
+* Effects: Appends the value to the buffer as a varint (7 bits per byte, with
+* the high bit set on every byte but the last)
+*/
+void putVarint(vector<uint8_t> &bytes, uint64_t value);
+
+// *** Decoding ***
+
+// Reads values from a range of bytes, and remembers if it ran past the end
+struct ByteReader {
+  const uint8_t *next;
+  const uint8_t *end;
+  bool isValid;
+
+  // Returns if there are at least size bytes left
+  bool has(size_t size) {
+    isValid = isValid && static_cast<size_t>(end - next) >= size;
+    return isValid;
+  }
+
+  // Returns the next value (or 0 if there isn't one), in little endian order
+  uint32_t getU32() {
+    uint32_t value = 0;
+    if (has(4)) {
+      for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(*next++) << (8 * i);
+      }
+    }
+    return value;
+  }
+  uint64_t getU64() {
+    uint64_t value = 0;
+    if (has(8)) {
+      for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(*next++) << (8 * i);
+      }
+    }
+    return value;
+  }
+  double getDouble() {
+    uint64_t bits = getU64();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  Color getColor() {
+    double r = getDouble();
+    double g = getDouble();
+    double b = getDouble();
+    return {r, g, b};
+  }
+  uint8_t getByte() {
+    return has(1) ? *next++ : 0;
+  }
+
+  // Returns the next varint (or 0 if there isn't a valid one)
+  uint64_t getVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && has(1); shift += 7) {
+      uint8_t byte = *next++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    isValid = false;
+    return 0;
+  }
+};
+
+// *** Save files ***
+
+/**
+* Requires: a filename
+* Modifies: nothing
+* Effects: Returns if the filename ends with the extension
+*/
+bool hasSaveExtension(const string &filename, const string &extension);
+
+/**
+* Requires: a filename
+* Modifies: nothing
+* Effects: Returns if the file starts with the binary save header
+*/
+bool isBinarySave(const string &filename);
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Returns the number of changes, loaded or not
+*/
+uint64_t countChanges(const SaveData &data);
+
+/**
+* Requires: save data
+* Modifies: data.changes
+* Effects: Drops the changes that are the same as the tile the save's
+* generator places there (like a wall that was removed and added again), so
+* the save only has what differs from the seed, returns the number dropped
+*  Note: chunks that aren't loaded are left as they are
+*/
+int normalizeChanges(SaveData &data);
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Encodes the header of the binary save layout, which is also the
+* layout of a summary file
+*/
+vector<uint8_t> encodeSaveSummary(const SaveData &data);
+
+/**
+* Requires: save data, whose unloaded chunks don't have any changes in the
+* changes map
+* Modifies: nothing
+* Effects: Encodes the save data in the binary save layout
+*/
+vector<uint8_t> encodeBinarySave(const SaveData &data);
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Encodes the save data as pretty printed JSON
+*/
+string encodeJsonSave(const SaveData &data);
+
+/**
+* Requires: a valid path to save the file to, and the contents of the file
+* Modifies: the file
+* Effects: Writes the contents to a temporary file next to the file, then
+* renames it over the file, so the file is never partly written, returns save
+* status
+*/
+bool writeFileAtomically(const string &filename, const void *contents, size_t size);
+
+/**
+* Requires: a valid path to save the file to, and save data
+* Modifies: the file
+* Effects: Writes the save data to the file in the binary save layout (or as
+* JSON), returns save status
+*/
+bool writeBinarySave(const string &filename, const SaveData &data);
+
+/**
+* Requires: a valid path to save the file to, and save data
+* Modifies: the file and its summary file
+* Effects: Writes the save data to the file as JSON, and its summary next to
+* it (since the summary can't be read from JSON without reading the whole
+* file), returns save status
+*/
+bool writeJsonSave(const string &filename, const SaveData &data);
+
+/**
+* Requires: a valid path to save the file to, and save data
+* Modifies: the file
+* Effects: Writes the save data to the file as JSON if it ends with
+* JSON_SAVE_EXTENSION, otherwise in the binary layout, returns save status
+*/
+bool writeSave(const string &filename, const SaveData &data);
+
+/**
+* Requires: bytes in the binary save layout
+* Modifies: data
+* Effects: Decodes the save data from the bytes, returns if they were valid
+*/
+bool decodeBinarySave(const uint8_t *bytes, size_t size, SaveData &data);
+
+/**
+* Requires: a valid path to an existing binary save file
+* Modifies: data
+* Effects: Maps the file into memory and decodes everything but the chunks of
+* changes, which are left in data.unloadedChunks for decodeSaveChunk() with
+* data.file keeping the file mapped (older layouts are decoded in full),
+* returns load status
+*/
+bool openBinarySave(const string &filename, SaveData &data);
+
+/**
+* Requires: a chunk of the mapped save file
+* Modifies: changes
+* Effects: Decodes the chunk's changes into the map, keeping the changes that
+* are already in it (since they were made after the save), returns if they
+* were valid
+*/
+bool decodeSaveChunk(const MappedFile &file, const SaveChunk &chunk, ChangeMap &changes);
+
+/**
+* Requires: a valid path to an existing binary save file
+* Modifies: data
+* Effects: Maps the file into memory and decodes the save data straight from
+* it, returns load status
+*/
+bool readBinarySave(const string &filename, SaveData &data);
+
+/**
+* Requires: save data
+* Modifies: nothing
+* Effects: Returns the summary of the save data
+*/
+SaveSummary summarizeSave(const SaveData &data);
+
+/**
+* Requires: bytes in the layout of a binary save header from version 3 on
+* Modifies: summary
+* Effects: Decodes the summary from the header, returns if it was valid
+*/
+bool decodeSaveSummary(const uint8_t *bytes, size_t size, SaveSummary &summary);
+
+/**
+* Requires: a valid path to an existing save file
+* Modifies: summary
+* Effects: Reads the summary of the save from the header of a binary save, or
+* from the summary file of a JSON save, returns load status
+*  Note: saves from before the summary (or JSON saves changed after their
+*  summary) are read in full instead
+*/
+bool readSaveSummary(const string &filename, SaveSummary &summary);
+
+#endif
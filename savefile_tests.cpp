@@ -0,0 +1,391 @@
+#include "savefile_tests.hpp"
+#include "floor.hpp"
+#include "wall.hpp"
+#include <experimental/filesystem>
+#include <fstream>
+
+bool saveFileTests_run() {
+  cout << "Running Save File Tests:" << endl;
+  cout << "------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(saveFileTests_encode());
+  t.check(saveFileTests_files());
+  t.check(saveFileTests_summary());
+  t.check(saveFileTests_chunks());
+  t.check(saveFileTests_normalize());
+  t.check(saveFileTests_compressed());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Helpers ***
+
+// Encodes the save data in the first binary save layout
+static vector<uint8_t> encodeFirstLayout(const SaveData &data) {
+  // Use the header without the number of changes
+  vector<uint8_t> bytes = encodeSaveSummary(data);
+  bytes.resize(SAVE_SUMMARY_SIZE - 8);
+  bytes[8] = 1;
+
+  // Add one list of colors for the whole save
+  vector<uint64_t> keys = data.changes.getSortedKeys();
+  vector<int> fileIndices(TILE_PALETTE_SIZE, -1);
+  vector<uint8_t> fileColors;
+  for (uint64_t key : keys) {
+    uint8_t colorIndex = data.changes.getChange(ChangeMap::unpackColumn(key), ChangeMap::unpackRow(key)).colorIndex;
+    if (fileIndices[colorIndex] == -1) {
+      fileIndices[colorIndex] = fileColors.size();
+      fileColors.push_back(colorIndex);
+    }
+  }
+  putVarint(bytes, fileColors.size());
+  for (uint8_t colorIndex : fileColors) {
+    putColor(bytes, getPaletteColor(colorIndex));
+  }
+
+  // Add every change in one list
+  putVarint(bytes, keys.size());
+  int lastColumn = 0;
+  int lastRow = -1;
+  for (uint64_t key : keys) {
+    int column = ChangeMap::unpackColumn(key);
+    int row = ChangeMap::unpackRow(key);
+    Tile tile = data.changes.getChange(column, row);
+    putVarint(bytes, column - lastColumn);
+    putVarint(bytes, column == lastColumn ? row - lastRow - 1 : row);
+    bytes.push_back(static_cast<uint8_t>(tile.blockType | (tile.floorType << 4)));
+    putVarint(bytes, fileIndices[tile.colorIndex]);
+    lastColumn = column;
+    lastRow = row;
+  }
+
+  return bytes;
+}
+
+// *** Tests ***
+
+// Test encodeBinarySave() and decodeBinarySave()
+bool saveFileTests_encode() {
+  // Start new testing object
+  Testing t("encodeBinarySave() and decodeBinarySave()");
+
+  // Fill in save data with a custom player and a few changes
+  SaveData data;
+  data.gameVersion = 3;
+  data.saveTime = 1500000000;
+  data.numBlocksWide = 30;
+  data.numBlocksHigh = 5000;
+  data.blockWidth = 20;
+  data.blockHeight = 25;
+  data.leftDisplayEdge = 1000000000;
+  data.seed = -42;
+  data.percentWall = 0.35;
+  data.player.setColor({0.1, 0.2, 0.3});
+  data.player.setAlternateColor({0.4, 0.5, 0.6});
+  data.player.setVectorX(1000000005);
+  data.player.setVectorY(4999);
+  Wall customWall;
+  customWall.setColor({0.7, 0.8, 0.9});
+  data.changes.setChange(0, 0, GRASS_TILE);
+  data.changes.setChange(0, 7, tileFromBlock(Floor(SandFloor)));
+  data.changes.setChange(5, 4999, WALL_TILE);
+  data.changes.setChange(5, 3, tileFromBlock(customWall));
+  data.changes.setChange(1000000003, 2, tileFromBlock(Floor(DirtFloor)));
+
+  // Decode it again, which should give back the same data
+  vector<uint8_t> bytes = encodeBinarySave(data);
+  SaveData withCheckpoints = data;
+  withCheckpoints.checkpoints = {{STREAM_CHECKPOINT_INTERVAL, {1, 2, 0xFFFFFFFF}}, {5 * STREAM_CHECKPOINT_INTERVAL, {7}}};
+  vector<uint8_t> checkpointBytes = encodeBinarySave(withCheckpoints);
+  SaveData decoded;
+  t.check(decodeBinarySave(bytes.data(), bytes.size(), decoded), "Encoded save couldn't be decoded");
+  t.check(decoded.gameVersion == 3 && decoded.saveTime == 1500000000 && decoded.numBlocksWide == 30 && decoded.numBlocksHigh == 5000 && decoded.blockWidth == 20 && decoded.blockHeight == 25, "Header didn't round trip");
+  t.check(decoded.leftDisplayEdge == 1000000000 && decoded.seed == -42 && decoded.percentWall == 0.35, "Seed and position didn't round trip");
+  t.check(decoded.player.getColor().g == 0.2 && decoded.player.getAlternateColor().b == 0.6 && decoded.player.getVectorX() == 1000000005 && decoded.player.getVectorY() == 4999, "Player didn't round trip");
+  t.check(decoded.changes == data.changes, "Changes didn't round trip");
+  t.check(getPaletteColor(decoded.changes.getChange(5, 3).colorIndex).r == 0.7, "Custom color didn't round trip");
+  t.check(decoded.checkpoints.empty() && decodeBinarySave(checkpointBytes.data(), checkpointBytes.size(), decoded), "Save with checkpoints couldn't be decoded");
+  t.check(decoded.checkpoints.size() == 2 && decoded.checkpoints[1].column == 5 * STREAM_CHECKPOINT_INTERVAL && decoded.checkpoints[0].state == withCheckpoints.checkpoints[0].state, "Checkpoints didn't round trip");
+
+  // Saves from the first layout (with one list of changes, and without
+  // checkpoints) should still decode
+  vector<uint8_t> firstLayout = encodeFirstLayout(data);
+  t.check(decodeBinarySave(firstLayout.data(), firstLayout.size(), decoded) && decoded.changes == data.changes && decoded.checkpoints.empty(), "Save from the first layout wasn't decoded");
+
+  // Each change should only take a few bytes, plus one palette entry for
+  // each of the 5 colors
+  SaveData empty = data;
+  empty.changes.clear();
+  t.check(bytes.size() - encodeBinarySave(empty).size() < 5 * 8 + 5 * 24, "Changes take too many bytes");
+
+  // Every truncated save should be rejected
+  bool rejected = true;
+  for (size_t size = 0; size < bytes.size(); size++) {
+    rejected = rejected && !decodeBinarySave(bytes.data(), size, decoded);
+  }
+  t.check(rejected, "Truncated save was decoded");
+
+  // Saves with a bad header or from a newer layout should be rejected
+  vector<uint8_t> badMagic = bytes;
+  badMagic[0] = 'X';
+  vector<uint8_t> newerVersion = bytes;
+  newerVersion[8] = BINARY_SAVE_VERSION + 1;
+  t.check(!decodeBinarySave(badMagic.data(), badMagic.size(), decoded) && !decodeBinarySave(newerVersion.data(), newerVersion.size(), decoded), "Save with a bad header was decoded");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test writeBinarySave(), readBinarySave(), and rejecting invalid files
+bool saveFileTests_files() {
+  // Start new testing object
+  Testing t("writeBinarySave(), readBinarySave(), and invalid files");
+
+  // Write many changes to a file
+  SaveData data;
+  data.gameVersion = 2;
+  data.saveTime = 0;
+  data.numBlocksWide = 30;
+  data.numBlocksHigh = 20;
+  data.blockWidth = 30;
+  data.blockHeight = 30;
+  data.leftDisplayEdge = 0;
+  data.seed = 7;
+  data.percentWall = 0.3;
+  for (int column = 0; column < 10000; column += 3) {
+    data.changes.setChange(column, column % 20, column % 2 ? WALL_TILE : GRASS_TILE);
+  }
+  t.check(writeBinarySave("testing.infinity.bin", data), "Couldn't write the save");
+  t.check(isBinarySave("testing.infinity.bin") && hasSaveExtension("testing.infinity.bin", BINARY_SAVE_EXTENSION), "Save wasn't recognized as binary");
+
+  // Read it back through the mapped file
+  SaveData read;
+  t.check(readBinarySave("testing.infinity.bin", read) && read.changes == data.changes && read.seed == 7, "Save didn't read back");
+
+  // JSON, empty, and missing files shouldn't be read as binary saves
+  ofstream("testing.infinity.json") << "{}" << endl;
+  ofstream("testing.empty.infinity.bin").close();
+  t.check(!isBinarySave("testing.infinity.json") && !hasSaveExtension("testing.infinity.json", BINARY_SAVE_EXTENSION), "JSON save was recognized as binary");
+  t.check(!readBinarySave("testing.empty.infinity.bin", read) && !readBinarySave("does-not-exist.infinity.bin", read), "Empty or missing save was read");
+  remove("testing.empty.infinity.bin");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test encodeSaveSummary() and readSaveSummary()
+bool saveFileTests_summary() {
+  // Start new testing object
+  Testing t("encodeSaveSummary() and readSaveSummary()");
+
+  // Fill in save data with a few changes
+  SaveData data;
+  data.gameVersion = 2;
+  data.saveTime = 1500000000;
+  data.numBlocksWide = 30;
+  data.numBlocksHigh = 20;
+  data.blockWidth = 30;
+  data.blockHeight = 30;
+  data.leftDisplayEdge = 990;
+  data.seed = -7;
+  data.percentWall = 0.3;
+  data.player.setVectorX(1000);
+  data.player.setVectorY(12);
+  for (int column = 0; column < 300; column += 3) {
+    data.changes.setChange(column, column % 20, WALL_TILE);
+  }
+
+  // The summary should be the start of the binary save
+  vector<uint8_t> summaryBytes = encodeSaveSummary(data);
+  vector<uint8_t> bytes = encodeBinarySave(data);
+  t.check(summaryBytes.size() == SAVE_SUMMARY_SIZE && equal(summaryBytes.begin(), summaryBytes.end(), bytes.begin()), "Summary isn't the header of the save");
+  SaveSummary summary;
+  t.check(decodeSaveSummary(bytes.data(), bytes.size(), summary) && summary.gameVersion == 2 && summary.saveTime == 1500000000 && summary.seed == -7 && summary.percentWall == 0.3, "Summary didn't round trip");
+  t.check(summary.playerX == 1000 && summary.playerY == 12 && summary.numChanges == 100, "Player or number of changes didn't round trip");
+  t.check(!decodeSaveSummary(bytes.data(), SAVE_SUMMARY_SIZE - 1, summary), "Truncated summary was decoded");
+
+  // Binary saves should be summarized from their header
+  summary = {};
+  t.check(writeBinarySave("testing.summary.infinity.bin", data) && readSaveSummary("testing.summary.infinity.bin", summary) && summary.numChanges == 100 && summary.seed == -7, "Binary save wasn't summarized");
+
+  // JSON saves should be summarized from their summary file
+  summary = {};
+  t.check(writeJsonSave("testing.summary.infinity.json", data) && readSaveSummary("testing.summary.infinity.json", summary) && summary.numChanges == 100 && summary.playerX == 1000, "JSON save wasn't summarized");
+  ifstream summaryFile("testing.summary.infinity.json" + SAVE_SUMMARY_EXTENSION, ios::binary);
+  t.check(summaryFile.seekg(0, ios::end).tellg() == SAVE_SUMMARY_SIZE, "Summary file has the wrong size");
+  summaryFile.close();
+
+  // JSON saves with an older summary file (or none) should be read in full
+  data.changes.clear();
+  ofstream("testing.summary.infinity.json") << encodeJsonSave(data);
+  experimental::filesystem::last_write_time("testing.summary.infinity.json" + SAVE_SUMMARY_EXTENSION, experimental::filesystem::last_write_time("testing.summary.infinity.json") - chrono::seconds(10));
+  t.check(readSaveSummary("testing.summary.infinity.json", summary) && summary.numChanges == 0, "Outdated summary file was used");
+  remove(("testing.summary.infinity.json" + SAVE_SUMMARY_EXTENSION).c_str());
+  summary.numChanges = 5;
+  t.check(readSaveSummary("testing.summary.infinity.json", summary) && summary.numChanges == 0 && summary.seed == -7, "JSON save without a summary file wasn't summarized");
+
+  // Missing saves can't be summarized
+  t.check(!readSaveSummary("does-not-exist.infinity.bin", summary) && !readSaveSummary("does-not-exist.infinity.json", summary), "Missing save was summarized");
+
+  remove("testing.summary.infinity.bin");
+  remove("testing.summary.infinity.json");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test openBinarySave() and decodeSaveChunk()
+bool saveFileTests_chunks() {
+  // Start new testing object
+  Testing t("openBinarySave() and decodeSaveChunk()");
+
+  // Write changes spread over a few chunks
+  SaveData data;
+  data.gameVersion = 3;
+  data.saveTime = 0;
+  data.numBlocksWide = 30;
+  data.numBlocksHigh = 20;
+  data.blockWidth = 30;
+  data.blockHeight = 30;
+  data.leftDisplayEdge = 0;
+  data.seed = 7;
+  data.percentWall = 0.3;
+  for (int column = 0; column < 4 * SAVE_CHUNK_WIDTH; column += 5) {
+    data.changes.setChange(column, column % 20, column % 2 ? WALL_TILE : GRASS_TILE);
+  }
+  data.changes.setChange(100 * SAVE_CHUNK_WIDTH, 0, WALL_TILE);
+  t.check(writeBinarySave("testing.chunks.infinity.bin", data), "Couldn't write the save");
+
+  // Opening the save should only read the index of the chunks
+  SaveData opened;
+  t.check(openBinarySave("testing.chunks.infinity.bin", opened) && opened.changes.empty() && opened.file && opened.seed == 7, "Save wasn't opened");
+  t.check(opened.unloadedChunks.size() == 5 && opened.unloadedChunks[4].chunk == 100 && opened.unloadedChunks[4].numChanges == 1 && countChanges(opened) == data.changes.size(), "Index of the chunks is wrong");
+
+  // Chunks should keep the changes that are already in the map
+  opened.changes.setChange(5, 5, WALL_TILE);
+  t.check(decodeSaveChunk(*opened.file, opened.unloadedChunks[0], opened.changes) && opened.changes.getChange(5, 5) == WALL_TILE && opened.changes.getChange(0, 0) == GRASS_TILE, "Chunk replaced a newer change");
+  opened.changes.setChange(5, 5, data.changes.getChange(5, 5));
+  opened.unloadedChunks.erase(opened.unloadedChunks.begin());
+
+  // Saving with chunks that were never loaded should copy them as they are
+  vector<uint8_t> bytes = encodeBinarySave(opened);
+  SaveData decoded;
+  t.check(decodeBinarySave(bytes.data(), bytes.size(), decoded) && decoded.changes == data.changes && bytes == encodeBinarySave(data), "Unloaded chunks weren't copied");
+  t.check(encodeJsonSave(opened) == encodeJsonSave(data), "Unloaded chunks weren't in the JSON save");
+
+  // A chunk that isn't in the file should be rejected
+  SaveChunk outside = opened.unloadedChunks[0];
+  outside.offset = opened.file->getSize();
+  t.check(!decodeSaveChunk(*opened.file, outside, decoded.changes), "Chunk outside the file was decoded");
+
+  remove("testing.chunks.infinity.bin");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test normalizeChanges()
+bool saveFileTests_normalize() {
+  // Start new testing object
+  Testing t("normalizeChanges()");
+
+  // Set every cell of a few columns to its generated tile, and a few cells to
+  // something else
+  SaveData data;
+  data.gameVersion = 3;
+  data.numBlocksHigh = 100;
+  data.seed = 7;
+  data.percentWall = 0.3;
+  Generator generator(data.seed, data.percentWall, data.gameVersion);
+  vector<uint64_t> wallBits;
+  for (int column = 1000; column < 1010; column++) {
+    generator.generateColumn(column, data.numBlocksHigh, wallBits);
+    for (int row = 0; row < data.numBlocksHigh; row++) {
+      data.changes.setChange(column, row, (wallBits[row / 64] & (1ULL << (row % 64))) ? WALL_TILE : GRASS_TILE);
+    }
+  }
+  Tile sand = tileFromBlock(Floor(SandFloor));
+  Tile flipped = data.changes.getChange(1003, 40) == WALL_TILE ? GRASS_TILE : WALL_TILE;
+  data.changes.setChange(1003, 40, flipped);
+  data.changes.setChange(1005, 7, sand);
+  data.changes.setChange(5000, 200, sand); // Below the board
+
+  // Only the changes that differ from the generated tiles should be kept
+  t.check(normalizeChanges(data) == 10 * 100 - 2, "Wrong number of changes were dropped");
+  t.check(data.changes.size() == 3 && data.changes.getChange(1003, 40) == flipped && data.changes.getChange(1005, 7) == sand && data.changes.hasChange(5000, 200), "Wrong changes were kept");
+  t.check(normalizeChanges(data) == 0, "Normalizing again dropped changes");
+
+  // Legacy streams should be compared the same way
+  SaveData legacy = data;
+  legacy.gameVersion = LEGACY_GAME_VERSION;
+  legacy.changes.clear();
+  Generator legacyGenerator(legacy.seed, legacy.percentWall, legacy.gameVersion);
+  for (int column = 0; column < 3; column++) {
+    legacyGenerator.generateColumn(column, legacy.numBlocksHigh, wallBits);
+    legacy.changes.setChange(column, 0, (wallBits[0] & 1) ? WALL_TILE : GRASS_TILE);
+    legacy.changes.setChange(column, 1, (wallBits[0] & 2) ? GRASS_TILE : WALL_TILE);
+  }
+  t.check(normalizeChanges(legacy) == 3 && legacy.changes.size() == 3 && !legacy.changes.hasChange(2, 0) && legacy.changes.hasChange(2, 1), "Legacy changes weren't normalized");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test compressing the chunks of binary saves
+bool saveFileTests_compressed() {
+  // Start new testing object
+  Testing t("compressing the chunks of binary saves");
+
+  // Fill in save data with many changes over a few chunks
+  SaveData data;
+  data.gameVersion = 3;
+  data.saveTime = 0;
+  data.numBlocksWide = 30;
+  data.numBlocksHigh = 20;
+  data.blockWidth = 30;
+  data.blockHeight = 30;
+  data.leftDisplayEdge = 0;
+  data.seed = 7;
+  data.percentWall = 0.3;
+  for (int column = 0; column < 3 * SAVE_CHUNK_WIDTH; column++) {
+    data.changes.setChange(column, column % 20, column % 3 ? WALL_TILE : tileFromBlock(Floor(SandFloor)));
+  }
+  data.changes.setChange(50 * SAVE_CHUNK_WIDTH, 3, GRASS_TILE);
+
+  // Compressed saves should be smaller, and decode the same
+  vector<uint8_t> plain = encodeBinarySave(data);
+  data.isCompressed = true;
+  vector<uint8_t> compressed = encodeBinarySave(data);
+  SaveData decoded;
+  t.check(compressed.size() < plain.size() * 3 / 4, "Compressed save isn't smaller");
+  t.check(decodeBinarySave(compressed.data(), compressed.size(), decoded) && decoded.changes == data.changes && decoded.isCompressed, "Compressed save didn't round trip");
+  t.check(decodeBinarySave(plain.data(), plain.size(), decoded) && !decoded.isCompressed, "Plain save was read as compressed");
+
+  // Compressed chunks should be loaded one at a time, and copied as they are
+  // into saves that aren't compressed
+  t.check(writeBinarySave("testing.compressed.infinity.bin", data), "Couldn't write the save");
+  SaveData opened;
+  t.check(openBinarySave("testing.compressed.infinity.bin", opened) && opened.isCompressed && opened.unloadedChunks.size() == 4 && opened.unloadedChunks[1].rawSize > opened.unloadedChunks[1].size, "Compressed chunks weren't in the index");
+  t.check(decodeSaveChunk(*opened.file, opened.unloadedChunks[1], opened.changes) && opened.changes.size() == SAVE_CHUNK_WIDTH && opened.changes.getChange(SAVE_CHUNK_WIDTH + 1, (SAVE_CHUNK_WIDTH + 1) % 20) == data.changes.getChange(SAVE_CHUNK_WIDTH + 1, (SAVE_CHUNK_WIDTH + 1) % 20), "Compressed chunk wasn't decoded");
+  opened.unloadedChunks.erase(opened.unloadedChunks.begin() + 1);
+  opened.isCompressed = false;
+  vector<uint8_t> mixed = encodeBinarySave(opened);
+  t.check(decodeBinarySave(mixed.data(), mixed.size(), decoded) && decoded.changes == data.changes && !decoded.isCompressed, "Copied compressed chunks didn't decode");
+
+  // Every truncated compressed save should be rejected
+  bool rejected = true;
+  for (size_t size = 0; size < compressed.size(); size++) {
+    rejected = rejected && !decodeBinarySave(compressed.data(), size, decoded);
+  }
+  t.check(rejected, "Truncated compressed save was decoded");
+
+  remove("testing.compressed.infinity.bin");
+
+  return t.getResult(); // Return pass or fail result
+}
@@ -0,0 +1,57 @@
+#ifndef savefile_tests_hpp
+#define savefile_tests_hpp
+
+#include "savefile.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool saveFileTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests encodeBinarySave() and decodeBinarySave()
+*/
+bool saveFileTests_encode();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests writeBinarySave(), readBinarySave(), and rejecting invalid
+* files
+*/
+bool saveFileTests_files();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests encodeSaveSummary() and readSaveSummary()
+*/
+bool saveFileTests_summary();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests openBinarySave() and decodeSaveChunk()
+*/
+bool saveFileTests_chunks();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests normalizeChanges()
+*/
+bool saveFileTests_normalize();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests compressing the chunks of binary saves
+*/
+bool saveFileTests_compressed();
+
+#endif
@@ -0,0 +1,139 @@
+#include "savewriter.hpp"
+#include <ctime>
+
+/**
+* Requires: nothing
+* Modifies: everything
+* Effects: Starts a thread that writes the saves as they are requested
+*/
+SaveWriter::SaveWriter() {
+  hasWaiting = false;
+  isWaitingNormalized = false;
+  numRequested = 0;
+  numFinished = 0;
+  lastStatus = false;
+  lastFinishTime = 0;
+  stopping = false;
+
+  writer = thread(&SaveWriter::run, this);
+}
+
+/**
+* Requires: nothing
+* Modifies: everything
+* Effects: Finishes writing the saves that were requested, then joins the
+* thread
+*/
+SaveWriter::~SaveWriter() {
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_one();
+  writer.join();
+}
+
+/**
+* Requires: a valid path to save the file to (the same one for every save),
+* and a snapshot of the game
+* Modifies: the waiting save
+* Effects: Queues the snapshot to be written (as JSON if the filename ends
+* with JSON_SAVE_EXTENSION, otherwise in the binary layout), replacing a save
+* that hasn't started yet, and returns the number of the save (the changes
+* that match the generated tiles are dropped first on the writer's thread if
+* isNormalized is set)
+*/
+int SaveWriter::requestSave(const string &filename, SaveData &&data, bool isNormalized) {
+  int number;
+  {
+    lock_guard<mutex> guard(lock);
+    // Replace the waiting save, since the snapshot has every change it has
+    hasWaiting = true;
+    waitingFilename = filename;
+    waitingData = move(data);
+    isWaitingNormalized = isNormalized;
+    number = ++numRequested;
+  }
+  wake.notify_one();
+  return number;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if a save is waiting or being written
+*/
+bool SaveWriter::isWriting() const {
+  lock_guard<mutex> guard(lock);
+  return numFinished < numRequested;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of the last save that finished (0 if none
+* have), if it was written, and the time it finished
+*/
+int SaveWriter::getNumFinished() const {
+  lock_guard<mutex> guard(lock);
+  return numFinished;
+}
+bool SaveWriter::getLastStatus() const {
+  lock_guard<mutex> guard(lock);
+  return lastStatus;
+}
+long long SaveWriter::getLastFinishTime() const {
+  lock_guard<mutex> guard(lock);
+  return lastFinishTime;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Waits until every requested save has finished, and returns if the
+* last one was written
+*/
+bool SaveWriter::wait() {
+  unique_lock<mutex> guard(lock);
+  finished.wait(guard, [this] { return numFinished == numRequested; });
+  return lastStatus;
+}
+
+/**
+* Requires: nothing
+* Modifies: the waiting save, numFinished, lastStatus, and lastFinishTime
+* Effects: Writes the waiting saves until stopped
+*/
+void SaveWriter::run() {
+  unique_lock<mutex> guard(lock);
+  while (true) {
+    // Sleep until there is a save to write, or we are stopping (after the
+    // last save is written)
+    wake.wait(guard, [this] { return hasWaiting || stopping; });
+    if (!hasWaiting) {
+      return;
+    }
+
+    // Take the save, so a new request can replace it while it is written
+    string filename = move(waitingFilename);
+    SaveData data = move(waitingData);
+    bool isNormalized = isWaitingNormalized;
+    int number = numRequested;
+    hasWaiting = false;
+
+    // Normalize, encode, and write it without holding the lock
+    guard.unlock();
+    if (isNormalized) {
+      normalizeChanges(data);
+    }
+    bool isSaved = writeSave(filename, data);
+    guard.lock();
+
+    // Every save up to this one has finished, since the ones that were
+    // replaced had fewer changes
+    numFinished = number;
+    lastStatus = isSaved;
+    lastFinishTime = time(nullptr);
+    finished.notify_all();
+  }
+}
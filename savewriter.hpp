@@ -0,0 +1,98 @@
+#ifndef savewriter_hpp
+#define savewriter_hpp
+
+#include "savefile.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Writes saves on a background thread, so the game doesn't wait for them
+//  Note: only the newest save that hasn't started yet is kept, since it
+//  already has every change of the saves before it
+class SaveWriter {
+public:
+  /**
+  * Requires: nothing
+  * Modifies: everything
+  * Effects: Starts a thread that writes the saves as they are requested
+  */
+  SaveWriter();
+
+  /**
+  * Requires: nothing
+  * Modifies: everything
+  * Effects: Finishes writing the saves that were requested, then joins the
+  * thread
+  */
+  ~SaveWriter();
+
+  /**
+  * Requires: a valid path to save the file to (the same one for every save),
+  * and a snapshot of the game
+  * Modifies: the waiting save
+  * Effects: Queues the snapshot to be written (as JSON if the filename ends
+  * with JSON_SAVE_EXTENSION, otherwise in the binary layout), replacing a save
+  * that hasn't started yet, and returns the number of the save (the changes
+  * that match the generated tiles are dropped first on the writer's thread if
+  * isNormalized is set)
+  */
+  int requestSave(const string &filename, SaveData &&data, bool isNormalized = false);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if a save is waiting or being written
+  */
+  bool isWriting() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of the last save that finished (0 if none
+  * have), if it was written, and the time it finished
+  */
+  int getNumFinished() const;
+  bool getLastStatus() const;
+  long long getLastFinishTime() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Waits until every requested save has finished, and returns if the
+  * last one was written
+  */
+  bool wait();
+
+private:
+  // Store the newest save that hasn't started yet
+  bool hasWaiting;
+  string waitingFilename;
+  SaveData waitingData;
+  bool isWaitingNormalized;
+
+  // Store the number of the last save requested, the last save finished, and
+  // how the last one went
+  int numRequested;
+  int numFinished;
+  bool lastStatus;
+  long long lastFinishTime;
+
+  // The lock guards every field above
+  bool stopping;
+  mutable mutex lock;
+  condition_variable wake;
+  condition_variable finished;
+  thread writer;
+
+  /**
+  * Requires: nothing
+  * Modifies: the waiting save, numFinished, lastStatus, and lastFinishTime
+  * Effects: Writes the waiting saves until stopped
+  */
+  void run();
+};
+
+#endif
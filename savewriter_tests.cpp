@@ -0,0 +1,120 @@
+#include "savewriter_tests.hpp"
+#include <fstream>
+
+/**
+* Requires: a number of changes
+* Modifies: nothing
+* Effects: Returns save data with the changes, for the tests to write
+*/
+static SaveData makeSaveData(int numChanges) {
+  SaveData data;
+  data.gameVersion = 3;
+  data.saveTime = 0;
+  data.numBlocksWide = 30;
+  data.numBlocksHigh = 20;
+  data.blockWidth = 30;
+  data.blockHeight = 30;
+  data.leftDisplayEdge = 0;
+  data.seed = numChanges;
+  data.percentWall = 0.3;
+  for (int i = 0; i < numChanges; i++) {
+    data.changes.setChange(i / 20, i % 20, i % 3 ? GRASS_TILE : WALL_TILE);
+  }
+  return data;
+}
+
+bool saveWriterTests_run() {
+  cout << "Running Save Writer Tests:" << endl;
+  cout << "--------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(saveWriterTests_write());
+  t.check(saveWriterTests_coalesce());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test requestSave() and wait(), and writing files atomically
+bool saveWriterTests_write() {
+  // Start new testing object
+  Testing t("requestSave(), wait(), and atomic writes");
+
+  // Nothing has been written by a new writer
+  SaveWriter writer;
+  t.check(!writer.isWriting() && writer.getNumFinished() == 0 && writer.getLastFinishTime() == 0, "New writer has finished a save");
+
+  // A binary save should be written in the background
+  SaveData data = makeSaveData(1000);
+  SaveData copy = data;
+  t.check(writer.requestSave("testing.infinity.bin", move(copy)) == 1, "First save isn't number 1");
+  t.check(writer.wait() && !writer.isWriting() && writer.getNumFinished() == 1 && writer.getLastFinishTime() > 0, "Save didn't finish");
+  SaveData read;
+  t.check(readBinarySave("testing.infinity.bin", read) && read.changes == data.changes && read.seed == 1000, "Save wasn't written");
+  t.check(!ifstream("testing.infinity.bin.tmp"), "Temporary file was left behind");
+
+  // A normalized save should drop the changes that match the generated tiles
+  // (on the writer's thread)
+  copy = data;
+  SaveData normalized = data;
+  int numDropped = normalizeChanges(normalized);
+  writer.requestSave("testing.infinity.bin", move(copy), true);
+  t.check(writer.wait() && readBinarySave("testing.infinity.bin", read) && read.changes == normalized.changes && numDropped > 0, "Normalized save wasn't written");
+
+  // A JSON save should be written as JSON
+  copy = data;
+  writer.requestSave("testing.infinity.json", move(copy));
+  t.check(writer.wait() && !isBinarySave("testing.infinity.json") && ifstream("testing.infinity.json").peek() == '{', "JSON save wasn't written");
+
+  // A save that can't be written should report it
+  copy = data;
+  writer.requestSave("does-not-exist/testing.infinity.bin", move(copy));
+  t.check(!writer.wait() && writer.getNumFinished() == 4 && !writer.getLastStatus(), "Failed save was reported as written");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test joining saves that are requested while one is written
+bool saveWriterTests_coalesce() {
+  // Start new testing object
+  Testing t("joining saves");
+
+  // Request many large saves at once, so they pile up behind the first one
+  SaveData last;
+  {
+    SaveWriter writer;
+    for (int i = 1; i <= 20; i++) {
+      SaveData data = makeSaveData(20000 + i);
+      if (i == 20) {
+        last = data;
+      }
+      t.check(writer.requestSave("testing.infinity.bin", move(data)) == i, "Saves weren't numbered in order");
+    }
+
+    // Every save should count as finished once the newest one is written
+    t.check(writer.wait() && writer.getNumFinished() == 20, "Joined saves didn't all finish");
+    SaveData read;
+    t.check(readBinarySave("testing.infinity.bin", read) && read.seed == last.seed && read.changes == last.changes, "Newest save wasn't the one written");
+
+    // A save requested right before the writer is destroyed should still be
+    // written
+    last = makeSaveData(7);
+    SaveData copy = last;
+    writer.requestSave("testing.infinity.bin", move(copy));
+  }
+  SaveData read;
+  t.check(readBinarySave("testing.infinity.bin", read) && read.changes == last.changes, "Destroying the writer dropped a save");
+
+  return t.getResult(); // Return pass or fail result
+}
@@ -0,0 +1,28 @@
+#ifndef savewriter_tests_hpp
+#define savewriter_tests_hpp
+
+#include "savewriter.hpp"
+#include "testing.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool saveWriterTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests requestSave() and wait(), and writing files atomically
+*/
+bool saveWriterTests_write();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests joining saves that are requested while one is written
+*/
+bool saveWriterTests_coalesce();
+
+#endif
@@ -0,0 +1,107 @@
+#include "tile.hpp"
+#include <atomic>
+#include <unordered_map>
+
+// Store the palette of tile colors, starting with the colors every game uses
+//  Note: colors are only ever appended, so an index always maps to the same
+//  color
+static Color palette[TILE_PALETTE_SIZE] = {{0, 0, 0}, {0, 123 / 255.0, 12 / 255.0}, {237 / 255.0, 201 / 255.0, 175 / 255.0}, {120 / 255.0, 72 / 255.0, 0}};
+static atomic<int> paletteSize(4);
+
+/**
+* Requires: a color
+* Modifies: the tile palette
+* Effects: Returns the palette index of the color, adding it to the palette if
+* it isn't there yet (or the closest color if the palette is full)
+*/
+uint8_t getPaletteIndex(Color c) {
+  // Look for the color, keeping track of the closest one
+  int size = paletteSize;
+  int closest = 0;
+  double closestDistance = 4;
+  for (int i = 0; i < size; i++) {
+    double distance = (palette[i].r - c.r) * (palette[i].r - c.r) + (palette[i].g - c.g) * (palette[i].g - c.g) + (palette[i].b - c.b) * (palette[i].b - c.b);
+    if (distance == 0) {
+      return i;
+    }
+    if (distance < closestDistance) {
+      closest = i;
+      closestDistance = distance;
+    }
+  }
+
+  // Use the closest color if there isn't room for a new one
+  if (size == TILE_PALETTE_SIZE) {
+    return closest;
+  }
+
+  // Add the color before publishing the new size
+  palette[size] = c;
+  paletteSize = size + 1;
+  return size;
+}
+
+/**
+* Requires: a palette index
+* Modifies: nothing
+* Effects: Returns the color at the palette index
+*/
+Color getPaletteColor(uint8_t index) {
+  return palette[index];
+}
+
+/**
+* Requires: a wall or floor block
+* Modifies: the tile palette
+* Effects: Returns the tile for the block
+*/
+Tile tileFromBlock(const Block &b) {
+  // Only floors have a floor type
+  uint8_t floorType = 0;
+  if (b.getBlockType() == FloorBlock) {
+    floorType = dynamic_cast<const Floor &>(b).getFloorType();
+  }
+
+  return {static_cast<uint8_t>(b.getBlockType()), floorType, getPaletteIndex(b.getColor())};
+}
+
+/**
+* Requires: a wall or floor tile
+* Modifies: nothing
+* Effects: Returns a new block for the tile
+*/
+shared_ptr<Block> blockFromTile(Tile t) {
+  shared_ptr<Block> b;
+  if (t.blockType == FloorBlock) {
+    b = make_shared<Floor>(static_cast<FloorType>(t.floorType));
+  } else {
+    b = make_shared<Wall>();
+  }
+
+  // Floors take their color from their type, so only set it for walls
+  if (t.blockType != FloorBlock) {
+    b->setColor(getPaletteColor(t.colorIndex));
+  }
+
+  return b;
+}
+
+/**
+* Requires: a wall or floor tile
+* Modifies: nothing
+* Effects: Returns the flyweight block for the tile, which is shared by every
+* call with the same tile, so it must not be modified (switch to the flyweight
+* for the new tile instead)
+*/
+shared_ptr<Block> sharedBlockFromTile(Tile t) {
+  // Store one immutable block per tile
+  static unordered_map<uint32_t, shared_ptr<Block>> blocks;
+
+  // Create the block the first time the tile is seen
+  shared_ptr<Block> &b = blocks[(t.blockType << 16) | (t.floorType << 8) | t.colorIndex];
+  if (!b) {
+    b = blockFromTile(t);
+  }
+
+  return b;
+}
@@ -0,0 +1,77 @@
+#ifndef tile_hpp
+#define tile_hpp
+
+#include "floor.hpp"
+#include "wall.hpp"
+#include <cstdint>
+#include <memory>
+
+// Number of colors the tile palette can hold
+const int TILE_PALETTE_SIZE = 256;
+
+// Palette indices of the colors every game uses
+enum TileColor { WallColor = 0, GrassColor = 1, SandColor = 2, DirtColor = 3 };
+
+// Compact record for one cell of the board
+struct Tile {
+  uint8_t blockType;  // BlockType of the cell
+  uint8_t floorType;  // FloorType if the cell is a floor, otherwise 0
+  uint8_t colorIndex; // Index of the cell's color in the tile palette
+
+  // Returns if the player can move on top of the tile
+  bool canMoveOnTop() const {
+    return blockType == FloorBlock;
+  }
+
+  // Compare two tiles
+  bool operator==(const Tile &other) const {
+    return blockType == other.blockType && floorType == other.floorType && colorIndex == other.colorIndex;
+  }
+  bool operator!=(const Tile &other) const {
+    return !(*this == other);
+  }
+};
+
+// Tiles for the generated blocks
+const Tile WALL_TILE = {WallBlock, 0, WallColor};
+const Tile GRASS_TILE = {FloorBlock, GrassFloor, GrassColor};
+
+/**
+* Requires: a color
+* Modifies: the tile palette
+* Effects: Returns the palette index of the color, adding it to the palette if
+* it isn't there yet (or the closest color if the palette is full)
+*/
+uint8_t getPaletteIndex(Color c);
+
+/**
+* Requires: a palette index
+* Modifies: nothing
+* Effects: Returns the color at the palette index
+*/
+Color getPaletteColor(uint8_t index);
+
+/**
+* Requires: a wall or floor block
+* Modifies: the tile palette
+* Effects: Returns the tile for the block
+*/
+Tile tileFromBlock(const Block &b);
+
+/**
+* Requires: a wall or floor tile
+* Modifies: nothing
+* Effects: Returns a new block for the tile
+*/
+shared_ptr<Block> blockFromTile(Tile t);
+
+/**
+* Requires: a wall or floor tile
+* Modifies: nothing
+* Effects: Returns the flyweight block for the tile, which is shared by every
+* call with the same tile, so it must not be modified (switch to the flyweight
+* for the new tile instead)
+*/
+shared_ptr<Block> sharedBlockFromTile(Tile t);
+
+#endif
@@ -0,0 +1,130 @@
+#include "tilemesh.hpp"
+#include <algorithm>
+
+/**
+* Requires: a column (which can be negative)
+* Modifies: nothing
+* Effects: Returns the chunk the column is in
+*/
+static int getChunkOf(int column) {
+  return column >= 0 ? column / TILE_CHUNK_WIDTH : (column + 1) / TILE_CHUNK_WIDTH - 1;
+}
+
+/**
+* Requires: nothing
+* Modifies: chunks and numMerged
+* Effects: Creates a mesh without any rectangles
+*/
+TileMesh::TileMesh() {
+  numMerged = 0;
+}
+
+/**
+* Requires: the board, and a chunk of columns on it
+* Modifies: chunks and numMerged
+* Effects: Returns the rectangles that cover the cells of the chunk that are
+* on the board, merging them first if the chunk changed since they were
+*/
+const vector<TileMesh::Rect> &TileMesh::getChunk(const TileStore &board, int chunk) {
+  map<int, vector<Rect>>::iterator found = chunks.find(chunk);
+  if (found == chunks.end()) {
+    found = chunks.emplace(chunk, vector<Rect>()).first;
+    merge(board, chunk, found->second);
+    numMerged++;
+  }
+  return found->second;
+}
+
+/**
+* Requires: a column on the board
+* Modifies: chunks
+* Effects: Drops the rectangles of the column's chunk, once one of its cells
+* changed or the column was added
+*/
+void TileMesh::invalidateColumn(int column) {
+  chunks.erase(getChunkOf(column));
+}
+
+/**
+* Requires: the range of columns to keep
+* Modifies: chunks
+* Effects: Drops the rectangles of the chunks that are completely outside the
+* range (like the board does with its columns)
+*/
+void TileMesh::removeChunksOutside(int first, int last) {
+  chunks.erase(chunks.begin(), chunks.lower_bound(getChunkOf(first)));
+  chunks.erase(chunks.upper_bound(getChunkOf(last - 1)), chunks.end());
+}
+
+/**
+* Requires: nothing
+* Modifies: chunks
+* Effects: Drops every rectangle
+*/
+void TileMesh::clear() {
+  chunks.clear();
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of times a chunk was merged
+*/
+int TileMesh::getNumMerged() const {
+  return numMerged;
+}
+
+/**
+* Requires: the board, and a chunk of columns on it
+* Modifies: rects
+* Effects: Covers the cells of the chunk that are on the board with rectangles
+* of one color, greedily making each one as tall and then as wide as it can be
+*/
+void TileMesh::merge(const TileStore &board, int chunk, vector<Rect> &rects) {
+  int firstColumn = chunk * TILE_CHUNK_WIDTH;
+  int numRows = board.getNumRows();
+
+  // Store which cells of the chunk are in a rectangle already, a column at a
+  // time like the board
+  vector<bool> covered(static_cast<size_t>(TILE_CHUNK_WIDTH) * numRows, false);
+
+  for (int x = 0; x < TILE_CHUNK_WIDTH; x++) {
+    if (!board.hasColumn(firstColumn + x)) {
+      continue;
+    }
+    const Tile *tiles = board.getColumn(firstColumn + x);
+    for (int row = 0; row < numRows;) {
+      if (covered[static_cast<size_t>(x) * numRows + row]) {
+        row++;
+        continue;
+      }
+
+      // Grow the rectangle down the column while the cells match (columns
+      // are stored from the top row down, so this is the cheap direction)
+      uint8_t color = tiles[row].colorIndex;
+      int height = 1;
+      while (row + height < numRows && !covered[static_cast<size_t>(x) * numRows + row + height] && tiles[row + height].colorIndex == color) {
+        height++;
+      }
+
+      // Then grow it right while the whole span of the next column matches
+      int width = 1;
+      while (x + width < TILE_CHUNK_WIDTH && board.hasColumn(firstColumn + x + width)) {
+        const Tile *next = board.getColumn(firstColumn + x + width);
+        size_t offset = static_cast<size_t>(x + width) * numRows;
+        bool isMatch = true;
+        for (int i = row; i < row + height && isMatch; i++) {
+          isMatch = !covered[offset + i] && next[i].colorIndex == color;
+        }
+        if (!isMatch) {
+          break;
+        }
+        fill(covered.begin() + offset + row, covered.begin() + offset + row + height, true);
+        width++;
+      }
+
+      rects.push_back({firstColumn + x, row, width, height, color});
+      row += height;
+    }
+  }
+}
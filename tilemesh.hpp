@@ -0,0 +1,88 @@
+#ifndef tilemesh_hpp
+#define tilemesh_hpp
+
+#include "tilestore.hpp"
+#include <map>
+#include <vector>
+
+using namespace std;
+
+// Merges cells of the same color on the board into larger rectangles, so a
+// frame fills far fewer of them than there are cells, and keeps the
+// rectangles of each chunk of columns until a cell in it changes
+//  Note: rectangles never cross the edge of a chunk, or a column that isn't on
+//  the board
+class TileMesh {
+public:
+  // A rectangle of cells of one color
+  struct Rect {
+    int column;         // Left column on the board
+    int row;            // Top row
+    int width;          // Number of columns
+    int height;         // Number of rows
+    uint8_t colorIndex; // Index of the color in the tile palette
+  };
+
+  /**
+  * Requires: nothing
+  * Modifies: chunks and numMerged
+  * Effects: Creates a mesh without any rectangles
+  */
+  TileMesh();
+
+  /**
+  * Requires: the board, and a chunk of columns on it
+  * Modifies: chunks and numMerged
+  * Effects: Returns the rectangles that cover the cells of the chunk that are
+  * on the board, merging them first if the chunk changed since they were
+  */
+  const vector<Rect> &getChunk(const TileStore &board, int chunk);
+
+  /**
+  * Requires: a column on the board
+  * Modifies: chunks
+  * Effects: Drops the rectangles of the column's chunk, once one of its cells
+  * changed or the column was added
+  */
+  void invalidateColumn(int column);
+
+  /**
+  * Requires: the range of columns to keep
+  * Modifies: chunks
+  * Effects: Drops the rectangles of the chunks that are completely outside
+  * the range (like the board does with its columns)
+  */
+  void removeChunksOutside(int first, int last);
+
+  /**
+  * Requires: nothing
+  * Modifies: chunks
+  * Effects: Drops every rectangle
+  */
+  void clear();
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of times a chunk was merged
+  */
+  int getNumMerged() const;
+
+private:
+  // Store the rectangles of each chunk that was merged since it last changed
+  map<int, vector<Rect>> chunks;
+
+  // Store the number of times a chunk was merged
+  int numMerged;
+
+  /**
+  * Requires: the board, and a chunk of columns on it
+  * Modifies: rects
+  * Effects: Covers the cells of the chunk that are on the board with
+  * rectangles of one color, greedily making each one as tall and then as wide
+  * as it can be
+  */
+  static void merge(const TileStore &board, int chunk, vector<Rect> &rects);
+};
+
+#endif
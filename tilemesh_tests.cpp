@@ -0,0 +1,144 @@
+#include "tilemesh_tests.hpp"
+#include <random>
+
+/**
+* Requires: a store, a chunk, and its rectangles
+* Modifies: nothing
+* Effects: Returns if the rectangles cover every cell of the chunk that is in
+* the store exactly once, with the cell's color, and nothing else
+*/
+static bool coversChunk(const TileStore &s, int chunk, const vector<TileMesh::Rect> &rects) {
+  int firstColumn = chunk * TILE_CHUNK_WIDTH;
+  vector<int> numCovered(TILE_CHUNK_WIDTH * s.getNumRows(), 0);
+  for (const TileMesh::Rect &rect : rects) {
+    for (int column = rect.column; column < rect.column + rect.width; column++) {
+      for (int row = rect.row; row < rect.row + rect.height; row++) {
+        if (column < firstColumn || column >= firstColumn + TILE_CHUNK_WIDTH || row < 0 || row >= s.getNumRows() || !s.hasColumn(column) || s.getTile(column, row).colorIndex != rect.colorIndex) {
+          return false;
+        }
+        numCovered[(column - firstColumn) * s.getNumRows() + row]++;
+      }
+    }
+  }
+  for (int column = firstColumn; column < firstColumn + TILE_CHUNK_WIDTH; column++) {
+    for (int row = 0; row < s.getNumRows(); row++) {
+      if (numCovered[(column - firstColumn) * s.getNumRows() + row] != (s.hasColumn(column) ? 1 : 0)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool tileMeshTests_run() {
+  cout << "Running Tile Mesh Tests:" << endl;
+  cout << "------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(tileMeshTests_merge());
+  t.check(tileMeshTests_cache());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test that getChunk() covers every cell once with its color, in fewer
+// rectangles than cells
+bool tileMeshTests_merge() {
+  // Start new testing object
+  Testing t("getChunk() merging");
+
+  // A chunk of one color is one rectangle
+  TileStore s(50);
+  for (int column = 0; column < TILE_CHUNK_WIDTH; column++) {
+    Tile *tiles = s.addColumn(column);
+    fill(tiles, tiles + 50, GRASS_TILE);
+  }
+  TileMesh mesh;
+  const vector<TileMesh::Rect> &rects = mesh.getChunk(s, 0);
+  t.check(rects.size() == 1 && rects[0].column == 0 && rects[0].row == 0 && rects[0].width == TILE_CHUNK_WIDTH && rects[0].height == 50 && rects[0].colorIndex == GrassColor, "Chunk of one color isn't one rectangle");
+
+  // A wall splits the column it is in, and the rows next to it merge across
+  // the other columns
+  s.setTile(3, 10, WALL_TILE);
+  mesh.invalidateColumn(3);
+  t.check(coversChunk(s, 0, mesh.getChunk(s, 0)) && mesh.getChunk(s, 0).size() <= 6, "Wall didn't split the chunk into a few rectangles");
+
+  // Random walls and floors should be covered exactly, in fewer rectangles
+  // than cells, without crossing into the next chunk or a missing column
+  mt19937 random(42);
+  TileStore s2(40);
+  for (int column = TILE_CHUNK_WIDTH; column < 3 * TILE_CHUNK_WIDTH; column++) {
+    if (column == TILE_CHUNK_WIDTH + 20) {
+      continue;
+    }
+    Tile *tiles = s2.addColumn(column);
+    for (int row = 0; row < 40; row++) {
+      tiles[row] = random() % 10 < 3 ? WALL_TILE : random() % 10 < 8 ? GRASS_TILE : tileFromBlock(Floor(SandFloor));
+    }
+  }
+  TileMesh mesh2;
+  bool isCovered = true;
+  size_t numRects = 0;
+  for (int chunk = 0; chunk < 4; chunk++) {
+    isCovered = isCovered && coversChunk(s2, chunk, mesh2.getChunk(s2, chunk));
+    numRects += mesh2.getChunk(s2, chunk).size();
+  }
+  t.check(isCovered, "Rectangles don't cover each cell exactly once with its color");
+  t.check(mesh2.getChunk(s2, 0).empty() && mesh2.getChunk(s2, 3).empty(), "Chunk without columns has rectangles");
+  t.check(numRects * 3 < (2 * TILE_CHUNK_WIDTH - 1) * 40 * 2, "Random chunk wasn't merged into fewer rectangles");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test that getChunk() keeps the rectangles until invalidateColumn(),
+// removeChunksOutside(), or clear() drops them
+bool tileMeshTests_cache() {
+  // Start new testing object
+  Testing t("getChunk() caching");
+
+  // Fill three chunks with grass
+  TileStore s(8);
+  for (int column = 0; column < 3 * TILE_CHUNK_WIDTH; column++) {
+    Tile *tiles = s.addColumn(column);
+    fill(tiles, tiles + 8, GRASS_TILE);
+  }
+  TileMesh mesh;
+  for (int chunk = 0; chunk < 3; chunk++) {
+    mesh.getChunk(s, chunk);
+  }
+  mesh.getChunk(s, 1);
+  t.check(mesh.getNumMerged() == 3, "Chunk was merged again without a change");
+
+  // Changing a cell only merges its chunk again
+  s.setTile(TILE_CHUNK_WIDTH + 5, 2, WALL_TILE);
+  mesh.invalidateColumn(TILE_CHUNK_WIDTH + 5);
+  mesh.getChunk(s, 0);
+  t.check(coversChunk(s, 1, mesh.getChunk(s, 1)) && mesh.getNumMerged() == 4, "Only the changed chunk should be merged again");
+
+  // Dropping the chunks outside a range keeps the ones it touches
+  mesh.removeChunksOutside(TILE_CHUNK_WIDTH + 1, TILE_CHUNK_WIDTH + 2);
+  mesh.getChunk(s, 1);
+  t.check(mesh.getNumMerged() == 4, "removeChunksOutside() dropped a chunk in the range");
+  mesh.getChunk(s, 0);
+  mesh.getChunk(s, 2);
+  t.check(mesh.getNumMerged() == 6, "removeChunksOutside() didn't drop the chunks outside the range");
+
+  // Clearing drops every chunk
+  mesh.clear();
+  mesh.getChunk(s, 1);
+  t.check(mesh.getNumMerged() == 7, "clear() didn't drop the chunks");
+
+  return t.getResult(); // Return pass or fail result
+}
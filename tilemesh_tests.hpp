@@ -0,0 +1,30 @@
+#ifndef tilemesh_tests_hpp
+#define tilemesh_tests_hpp
+
+#include "testing.hpp"
+#include "tilemesh.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool tileMeshTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests that getChunk() covers every cell once with its color, in
+* fewer rectangles than cells
+*/
+bool tileMeshTests_merge();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests that getChunk() keeps the rectangles until
+* invalidateColumn(), removeChunksOutside(), or clear() drops them
+*/
+bool tileMeshTests_cache();
+
+#endif
@@ -0,0 +1,289 @@
+#include "tilestore.hpp"
+
+/**
+* Requires: nothing
+* Modifies: numRows and numColumns
+* Effects: Creates an empty store
+*/
+TileStore::TileStore() : TileStore(0) {
+}
+/**
+* Requires: a positive number of rows
+* Modifies: numRows and numColumns
+* Effects: Creates an empty store for columns of the height
+*/
+TileStore::TileStore(int nRows) {
+  clear(nRows);
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the height of each column, or one past the last column
+* that has been added
+*/
+int TileStore::getNumRows() const {
+  return numRows;
+}
+int TileStore::getNumColumns() const {
+  return numColumns;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns if the column has been added to the store
+*/
+bool TileStore::hasColumn(int column) const {
+  // Make sure the column is within the store
+  if (column < 0 || column >= numColumns) {
+    return false;
+  }
+
+  // Make sure the column's chunk is stored
+  int chunkIndex = column / TILE_CHUNK_WIDTH;
+  if (chunkIndex < firstChunk || chunkIndex >= firstChunk + chunks.size()) {
+    return false;
+  }
+
+  // Check the chunk exists and has the column
+  const unique_ptr<Chunk> &chunk = getChunk(column);
+  return chunk && (chunk->columns >> (column % TILE_CHUNK_WIDTH)) & 1;
+}
+
+/**
+* Requires: a column that has been added and a row within the column
+* Modifies: nothing
+* Effects: Returns the tile at the position
+*/
+Tile TileStore::getTile(int column, int row) const {
+  return getChunk(column)->tiles[(column % TILE_CHUNK_WIDTH) * numRows + row];
+}
+
+/**
+* Requires: a column that has been added and a row within the column
+* Modifies: the tile at the position
+* Effects: Sets the tile at the position, keeping its walkability in sync
+*/
+void TileStore::setTile(int column, int row, Tile t) {
+  const unique_ptr<Chunk> &chunk = getChunk(column);
+  chunk->tiles[(column % TILE_CHUNK_WIDTH) * numRows + row] = t;
+
+  // Set or clear the walkability bit of the tile
+  uint64_t &word = chunk->walkable[(column % TILE_CHUNK_WIDTH) * wordsPerColumn + row / 64];
+  if (t.canMoveOnTop()) {
+    word |= 1ULL << (row % 64);
+  } else {
+    word &= ~(1ULL << (row % 64));
+  }
+}
+
+/**
+* Requires: a column that has been added and a row within the column
+* Modifies: nothing
+* Effects: Returns if the tile at the position can be moved on top of
+*/
+bool TileStore::isWalkable(int column, int row) const {
+  return (getWalkableBits(column)[row / 64] >> (row % 64)) & 1;
+}
+
+/**
+* Requires: a column that has been added
+* Modifies: nothing
+* Effects: Returns the walkability bits of the column (bit (row % 64) of word
+* (row / 64) is set if the row can be moved on top of)
+*/
+const uint64_t *TileStore::getWalkableBits(int column) const {
+  return &getChunk(column)->walkable[(column % TILE_CHUNK_WIDTH) * wordsPerColumn];
+}
+
+/**
+* Requires: a column that has been added
+* Modifies: nothing
+* Effects: Returns if any tile in the column can be moved on top of
+*/
+bool TileStore::hasWalkableTile(int column) const {
+  // Bits past the last row are never set, so any set bit is a walkable tile
+  const uint64_t *bits = getWalkableBits(column);
+  for (int word = 0; word < wordsPerColumn; word++) {
+    if (bits[word]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of tiles that can't be moved on top of in the
+* columns that have been added from firstColumn up to (but not including)
+* lastColumn, and rows from firstRow up to (but not including) lastRow
+*/
+int TileStore::countWalls(int firstColumn, int lastColumn, int firstRow, int lastRow) const {
+  // Keep the rows within the columns
+  firstRow = max(firstRow, 0);
+  lastRow = min(lastRow, numRows);
+  if (firstRow >= lastRow) {
+    return 0;
+  }
+
+  int numWalls = 0;
+  for (ColumnView view : getColumns(firstColumn, lastColumn)) {
+    const uint64_t *bits = getWalkableBits(view.column);
+    for (int word = firstRow / 64; word <= (lastRow - 1) / 64; word++) {
+      // Mask off the rows outside the range in the first and last words
+      uint64_t rows = ~0ULL;
+      if (word == firstRow / 64) {
+        rows &= ~0ULL << (firstRow % 64);
+      }
+      if (word == (lastRow - 1) / 64 && lastRow % 64 != 0) {
+        rows &= ~0ULL >> (64 - lastRow % 64);
+      }
+      numWalls += __builtin_popcountll(~bits[word] & rows);
+    }
+  }
+  return numWalls;
+}
+
+/**
+* Requires: a column that has been added
+* Modifies: the walkability of the column
+* Effects: Updates the walkability of the column after its tiles were filled
+* in through addColumn() (only touches this column, so different columns can
+* be updated from different threads)
+*/
+void TileStore::updateWalkable(int column) {
+  const unique_ptr<Chunk> &chunk = getChunk(column);
+  const Tile *tiles = &chunk->tiles[(column % TILE_CHUNK_WIDTH) * numRows];
+  uint64_t *bits = &chunk->walkable[(column % TILE_CHUNK_WIDTH) * wordsPerColumn];
+  fill(bits, bits + wordsPerColumn, 0);
+  for (int row = 0; row < numRows; row++) {
+    bits[row / 64] |= static_cast<uint64_t>(tiles[row].canMoveOnTop()) << (row % 64);
+  }
+}
+
+/**
+* Requires: a column that has been added
+* Modifies: nothing
+* Effects: Returns the tiles of the column, which are contiguous in memory
+*/
+const Tile *TileStore::getColumn(int column) const {
+  return &getChunk(column)->tiles[(column % TILE_CHUNK_WIDTH) * numRows];
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns a view of the columns that have been added from first up
+* to (but not including) last
+*/
+TileStore::ColumnRange TileStore::getColumns(int first, int last) const {
+  return ColumnRange(this, first, last);
+}
+
+/**
+* Requires: a non-negative column
+* Modifies: chunks and numColumns
+* Effects: Adds the column to the store, and returns its tiles to be filled
+* (followed by updateWalkable() once they are)
+*/
+Tile *TileStore::addColumn(int column) {
+  // Grow the list of chunks to fit the column on either side
+  int chunkIndex = column / TILE_CHUNK_WIDTH;
+  if (chunks.empty()) {
+    firstChunk = chunkIndex;
+  }
+  while (chunkIndex < firstChunk) {
+    chunks.emplace_front();
+    firstChunk--;
+  }
+  while (chunkIndex >= firstChunk + chunks.size()) {
+    chunks.emplace_back();
+  }
+
+  // Create the chunk the first time one of its columns is added
+  unique_ptr<Chunk> &chunk = chunks[chunkIndex - firstChunk];
+  if (!chunk) {
+    chunk = make_unique<Chunk>();
+    chunk->tiles.resize(TILE_CHUNK_WIDTH * numRows);
+    chunk->walkable.resize(TILE_CHUNK_WIDTH * wordsPerColumn);
+    chunk->columns = 0;
+  }
+
+  // Mark the column as added
+  chunk->columns |= 1ULL << (column % TILE_CHUNK_WIDTH);
+  numColumns = max(numColumns, column + 1);
+
+  return &chunk->tiles[(column % TILE_CHUNK_WIDTH) * numRows];
+}
+
+/**
+* Requires: first to be at most last
+* Modifies: chunks, firstChunk, and numColumns
+* Effects: Removes every chunk that has no columns between first and last
+*/
+void TileStore::removeChunksOutside(int first, int last) {
+  // Remove the chunks left of first
+  while (!chunks.empty() && (firstChunk + 1) * TILE_CHUNK_WIDTH <= first) {
+    chunks.pop_front();
+    firstChunk++;
+  }
+
+  // Remove the chunks right of last, and any empty chunks on either end
+  while (!chunks.empty() && ((firstChunk + (int)chunks.size() - 1) * TILE_CHUNK_WIDTH > last || !chunks.back())) {
+    chunks.pop_back();
+  }
+  while (!chunks.empty() && !chunks.front()) {
+    chunks.pop_front();
+    firstChunk++;
+  }
+
+  // The last column is now in the last chunk
+  numColumns = 0;
+  if (!chunks.empty()) {
+    uint64_t columns = chunks.back()->columns;
+    int lastColumn = TILE_CHUNK_WIDTH - 1;
+    while (!((columns >> lastColumn) & 1)) {
+      lastColumn--;
+    }
+    numColumns = (firstChunk + chunks.size() - 1) * TILE_CHUNK_WIDTH + lastColumn + 1;
+  }
+}
+
+/**
+* Requires: a positive number of rows
+* Modifies: chunks, numRows, and numColumns
+* Effects: Removes every column, and sets the height of new columns
+*/
+void TileStore::clear(int nRows) {
+  chunks.clear();
+  firstChunk = 0;
+  numRows = nRows;
+  numColumns = 0;
+  wordsPerColumn = (numRows + 63) / 64;
+}
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Returns the number of bytes used by the chunks
+*/
+size_t TileStore::getMemoryUsage() const {
+  size_t bytes = chunks.size() * sizeof(unique_ptr<Chunk>);
+  for (const unique_ptr<Chunk> &chunk : chunks) {
+    if (chunk) {
+      bytes += sizeof(Chunk) + chunk->tiles.capacity() * sizeof(Tile) + chunk->walkable.capacity() * sizeof(uint64_t);
+    }
+  }
+  return bytes;
+}
+
+/**
+* Requires: a column within the chunks
+* Modifies: nothing
+* Effects: Returns the chunk holding the column
+*/
+const unique_ptr<TileStore::Chunk> &TileStore::getChunk(int column) const {
+  return chunks[column / TILE_CHUNK_WIDTH - firstChunk];
+}
@@ -0,0 +1,226 @@
+#ifndef tilestore_hpp
+#define tilestore_hpp
+
+#include "tile.hpp"
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Number of columns stored together in one chunk
+const int TILE_CHUNK_WIDTH = 64;
+
+class TileStore {
+public:
+  // A column that has been added, pointing into the store
+  struct ColumnView {
+    int column;        // Column on the board
+    const Tile *tiles; // Tiles of the column, from the top row down
+  };
+
+  // Iterates over the columns that have been added in a range, skipping the
+  // rest, without copying any tiles
+  class ColumnRange {
+  public:
+    class const_iterator {
+    public:
+      const_iterator(const TileStore *s, int c, int l) : store(s), column(c), last(l) {
+        skipMissing();
+      }
+      ColumnView operator*() const {
+        return {column, store->getColumn(column)};
+      }
+      const_iterator &operator++() {
+        column++;
+        skipMissing();
+        return *this;
+      }
+      bool operator==(const const_iterator &other) const {
+        return column == other.column;
+      }
+      bool operator!=(const const_iterator &other) const {
+        return column != other.column;
+      }
+
+    private:
+      const TileStore *store;
+      int column;
+      int last;
+      void skipMissing() {
+        while (column < last && !store->hasColumn(column)) {
+          column++;
+        }
+      }
+    };
+
+    ColumnRange(const TileStore *s, int f, int l) : store(s), first(f), last(max(f, l)) {
+    }
+    const_iterator begin() const {
+      return const_iterator(store, first, last);
+    }
+    const_iterator end() const {
+      return const_iterator(store, last, last);
+    }
+
+  private:
+    const TileStore *store;
+    int first;
+    int last;
+  };
+
+  /**
+  * Requires: nothing
+  * Modifies: numRows and numColumns
+  * Effects: Creates an empty store
+  */
+  TileStore();
+  /**
+  * Requires: a positive number of rows
+  * Modifies: numRows and numColumns
+  * Effects: Creates an empty store for columns of the height
+  */
+  TileStore(int nRows);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the height of each column, or one past the last column
+  * that has been added
+  */
+  int getNumRows() const;
+  int getNumColumns() const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns if the column has been added to the store
+  */
+  bool hasColumn(int column) const;
+
+  /**
+  * Requires: a column that has been added and a row within the column
+  * Modifies: nothing
+  * Effects: Returns the tile at the position
+  */
+  Tile getTile(int column, int row) const;
+
+  /**
+  * Requires: a column that has been added and a row within the column
+  * Modifies: the tile at the position
+  * Effects: Sets the tile at the position, keeping its walkability in sync
+  */
+  void setTile(int column, int row, Tile t);
+
+  /**
+  * Requires: a column that has been added and a row within the column
+  * Modifies: nothing
+  * Effects: Returns if the tile at the position can be moved on top of
+  */
+  bool isWalkable(int column, int row) const;
+
+  /**
+  * Requires: a column that has been added
+  * Modifies: nothing
+  * Effects: Returns the walkability bits of the column (bit (row % 64) of word
+  * (row / 64) is set if the row can be moved on top of)
+  */
+  const uint64_t *getWalkableBits(int column) const;
+
+  /**
+  * Requires: a column that has been added
+  * Modifies: nothing
+  * Effects: Returns if any tile in the column can be moved on top of
+  */
+  bool hasWalkableTile(int column) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of tiles that can't be moved on top of in the
+  * columns that have been added from firstColumn up to (but not including)
+  * lastColumn, and rows from firstRow up to (but not including) lastRow
+  */
+  int countWalls(int firstColumn, int lastColumn, int firstRow, int lastRow) const;
+
+  /**
+  * Requires: a column that has been added
+  * Modifies: the walkability of the column
+  * Effects: Updates the walkability of the column after its tiles were filled
+  * in through addColumn() (only touches this column, so different columns can
+  * be updated from different threads)
+  */
+  void updateWalkable(int column);
+
+  /**
+  * Requires: a column that has been added
+  * Modifies: nothing
+  * Effects: Returns the tiles of the column, which are contiguous in memory
+  */
+  const Tile *getColumn(int column) const;
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns a view of the columns that have been added from first up
+  * to (but not including) last
+  */
+  ColumnRange getColumns(int first, int last) const;
+
+  /**
+  * Requires: a non-negative column
+  * Modifies: chunks and numColumns
+  * Effects: Adds the column to the store, and returns its tiles to be filled
+  * (followed by updateWalkable() once they are)
+  */
+  Tile *addColumn(int column);
+
+  /**
+  * Requires: first to be at most last
+  * Modifies: chunks, firstChunk, and numColumns
+  * Effects: Removes every chunk that has no columns between first and last
+  */
+  void removeChunksOutside(int first, int last);
+
+  /**
+  * Requires: a positive number of rows
+  * Modifies: chunks, numRows, and numColumns
+  * Effects: Removes every column, and sets the height of new columns
+  */
+  void clear(int nRows);
+
+  /**
+  * Requires: nothing
+  * Modifies: nothing
+  * Effects: Returns the number of bytes used by the chunks
+  */
+  size_t getMemoryUsage() const;
+
+private:
+  // Tiles for TILE_CHUNK_WIDTH columns, stored column after column
+  struct Chunk {
+    vector<Tile> tiles;
+    vector<uint64_t> walkable; // wordsPerColumn words of walkability bits per column
+    uint64_t columns;          // Bit (column % TILE_CHUNK_WIDTH) is set if it was added
+  };
+
+  // Store the chunks, which are empty until a column in them is added
+  //  Note: chunks[i] holds the columns of chunk (firstChunk + i)
+  deque<unique_ptr<Chunk>> chunks;
+  int firstChunk;
+
+  /**
+  * Requires: a column within the chunks
+  * Modifies: nothing
+  * Effects: Returns the chunk holding the column
+  */
+  const unique_ptr<Chunk> &getChunk(int column) const;
+
+  // Store the height of each column, and one past the last column added
+  int numRows;
+  int numColumns;
+
+  // Number of 64 bit words of walkability bits for each column
+  int wordsPerColumn;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "tilestore_tests.hpp"
+
+bool tileStoreTests_run() {
+  cout << "Running Tile Store Tests:" << endl;
+  cout << "-------------------------" << endl;
+
+  // Create a new testing object to keep track of the results of each test
+  Testing t;
+
+  // Run all tests
+  t.check(tileStoreTests_tiles());
+  t.check(tileStoreTests_columns());
+  t.check(tileStoreTests_walkable());
+
+  // Display pass or fail result
+  if (t.getResult()) {
+    cout << "Done testing. All " << t.getNumTested() << " tests passed!" << endl;
+  } else {
+    cout << "Failed " << t.getNumFailed() << "/" << t.getNumTested() << " test(s). See message(s) above." << endl;
+  }
+
+  return t.getResult();
+}
+
+// *** Tests ***
+
+// Test tileFromBlock(), blockFromTile(), and the palette
+bool tileStoreTests_tiles() {
+  // Start new testing object
+  Testing t("tileFromBlock(), blockFromTile(), and the palette");
+
+  // The generated blocks should map to the generated tiles
+  t.check(tileFromBlock(Wall()) == WALL_TILE, "Default wall isn't the wall tile");
+  t.check(tileFromBlock(Floor()) == GRASS_TILE, "Default floor isn't the grass tile");
+  t.check(tileFromBlock(Floor(DirtFloor)).colorIndex == DirtColor && tileFromBlock(Floor(SandFloor)).colorIndex == SandColor, "Floor types don't use their palette colors");
+
+  // Convert a sand floor to a tile and back
+  shared_ptr<Block> b1 = blockFromTile(tileFromBlock(Floor(SandFloor)));
+  t.check(b1->getBlockType() == FloorBlock && dynamic_pointer_cast<Floor>(b1)->getFloorType() == SandFloor, "Floor didn't convert to a tile and back");
+
+  // Convert a custom colored wall to a tile and back
+  Wall w;
+  w.setColor({0.25, 0.5, 0.75});
+  shared_ptr<Block> b2 = blockFromTile(tileFromBlock(w));
+  t.check(b2->getBlockType() == WallBlock && b2->getColor().r == 0.25 && b2->getColor().g == 0.5 && b2->getColor().b == 0.75, "Custom colored wall didn't convert to a tile and back");
+  t.check(tileFromBlock(w) == tileFromBlock(*b2), "Custom color was added to the palette twice");
+
+  // Shared blocks should be the same for the same tile
+  t.check(sharedBlockFromTile(WALL_TILE) == sharedBlockFromTile(WALL_TILE) && sharedBlockFromTile(WALL_TILE) != sharedBlockFromTile(GRASS_TILE), "Shared blocks aren't shared per tile");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test addColumn(), hasColumn(), getTile(), setTile(), and getColumn()
+bool tileStoreTests_columns() {
+  // Start new testing object
+  Testing t("addColumn(), hasColumn(), getTile(), setTile(), and getColumn()");
+
+  // Create an empty store
+  TileStore s(5);
+  t.check(s.getNumRows() == 5 && s.getNumColumns() == 0 && !s.hasColumn(0), "Empty store isn't empty");
+
+  // Add a column in the second chunk, skipping the first
+  Tile *tiles = s.addColumn(TILE_CHUNK_WIDTH + 1);
+  for (int row = 0; row < 5; row++) {
+    tiles[row] = row % 2 == 0 ? WALL_TILE : GRASS_TILE;
+  }
+  t.check(s.getNumColumns() == TILE_CHUNK_WIDTH + 2, "Number of columns isn't one past the last column");
+  t.check(s.hasColumn(TILE_CHUNK_WIDTH + 1) && !s.hasColumn(TILE_CHUNK_WIDTH) && !s.hasColumn(0), "Only the added column should be in the store");
+  t.check(s.getTile(TILE_CHUNK_WIDTH + 1, 0) == WALL_TILE && s.getTile(TILE_CHUNK_WIDTH + 1, 1) == GRASS_TILE, "Tiles weren't stored");
+
+  // Set a tile and read it back through the column
+  s.setTile(TILE_CHUNK_WIDTH + 1, 1, WALL_TILE);
+  t.check(s.getColumn(TILE_CHUNK_WIDTH + 1)[1] == WALL_TILE, "setTile() didn't change the column");
+
+  // Clearing should remove every column
+  size_t usedMemory = s.getMemoryUsage();
+  s.clear(7);
+  t.check(s.getNumRows() == 7 && s.getNumColumns() == 0 && !s.hasColumn(TILE_CHUNK_WIDTH + 1) && s.getMemoryUsage() < usedMemory, "clear() didn't remove the columns");
+
+  return t.getResult(); // Return pass or fail result
+}
+
+// Test isWalkable(), hasWalkableTile(), countWalls(), and updateWalkable()
+bool tileStoreTests_walkable() {
+  // Start new testing object
+  Testing t("isWalkable(), hasWalkableTile(), countWalls(), and updateWalkable()");
+
+  // Fill two tall columns, one with every third row a wall and one all walls
+  TileStore s(130);
+  Tile *tiles = s.addColumn(3);
+  for (int row = 0; row < 130; row++) {
+    tiles[row] = row % 3 == 0 ? WALL_TILE : GRASS_TILE;
+  }
+  s.updateWalkable(3);
+  tiles = s.addColumn(4);
+  fill(tiles, tiles + 130, WALL_TILE);
+  s.updateWalkable(4);
+
+  // The walkability should match the tiles
+  bool matches = true;
+  for (int row = 0; row < 130; row++) {
+    matches = matches && s.isWalkable(3, row) == s.getTile(3, row).canMoveOnTop() && !s.isWalkable(4, row);
+  }
+  t.check(matches, "Walkability doesn't match the tiles");
+  t.check(s.hasWalkableTile(3) && !s.hasWalkableTile(4), "hasWalkableTile() doesn't match the tiles");
+
+  // Count the walls in whole columns and in ranges that cross words
+  t.check(s.countWalls(0, 10, 0, 130) == 44 + 130, "countWalls() didn't count every wall");
+  t.check(s.countWalls(3, 4, 60, 70) == 4 && s.countWalls(4, 5, 63, 129) == 66, "countWalls() didn't count the range of rows");
+  t.check(s.countWalls(5, 10, 0, 130) == 0 && s.countWalls(3, 5, 70, 60) == 0, "countWalls() counted walls outside the range");
+
+  // Setting a tile should keep its walkability in sync
+  s.setTile(4, 129, GRASS_TILE);
+  s.setTile(3, 1, WALL_TILE);
+  t.check(s.isWalkable(4, 129) && !s.isWalkable(3, 1) && s.hasWalkableTile(4), "setTile() didn't update the walkability");
+  t.check(s.countWalls(3, 5, 0, 130) == 44 + 1 + 129, "countWalls() doesn't match after setTile()");
+
+  return t.getResult(); // Return pass or fail result
+}
@@ -0,0 +1,37 @@
+#ifndef tilestore_tests_hpp
+#define tilestore_tests_hpp
+
+#include "testing.hpp"
+#include "tilestore.hpp"
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Runs all tests
+*/
+bool tileStoreTests_run();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests tileFromBlock(), blockFromTile(), and the palette
+*/
+bool tileStoreTests_tiles();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests addColumn(), hasColumn(), getTile(), setTile(), and
+* getColumn()
+*/
+bool tileStoreTests_columns();
+
+/**
+* Requires: nothing
+* Modifies: nothing
+* Effects: Tests isWalkable(), hasWalkableTile(), countWalls(), and
+* updateWalkable()
+*/
+bool tileStoreTests_walkable();
+
+#endif